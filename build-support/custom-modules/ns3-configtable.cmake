@@ -133,12 +133,21 @@ macro(write_configtable)
   string(APPEND out "Build with runtime logging    : ")
   check_on_or_off("NS3_LOG" "NS3_LOG")
 
+  if(NOT "${NS3_LOG_COMPONENTS}" STREQUAL "")
+    string(APPEND out
+           "Log components compiled in    : ${NS3_LOG_COMPONENTS}\n"
+    )
+  endif()
+
   string(APPEND out "Build version embedding       : ")
   check_on_or_off("NS3_ENABLE_BUILD_VERSION" "ENABLE_BUILD_VERSION")
 
   string(APPEND out "BRITE Integration             : ")
   check_on_or_off("ON" "NS3_BRITE")
 
+  string(APPEND out "Control loop timing probes    : ")
+  check_on_or_off("NS3_CONTROL_LOOP_PROBES" "NS3_CONTROL_LOOP_PROBES")
+
   string(APPEND out "DES Metrics event collection  : ")
   check_on_or_off("NS3_DES_METRICS" "NS3_DES_METRICS")
 
@@ -148,6 +157,9 @@ macro(write_configtable)
   string(APPEND out "Emulation FdNetDevice         : ")
   check_on_or_off("ENABLE_EMU" "ENABLE_EMUNETDEV")
 
+  string(APPEND out "Event allocation pool         : ")
+  check_on_or_off("NS3_EVENT_POOL" "NS3_EVENT_POOL")
+
   string(APPEND out "Examples                      : ")
   check_on_or_off("ENABLE_EXAMPLES" "ENABLE_EXAMPLES")
 
@@ -166,6 +178,9 @@ macro(write_configtable)
   string(APPEND out "MPI Support                   : ")
   check_on_or_off("NS3_MPI" "MPI_FOUND")
 
+  string(APPEND out "Multithreaded simulation      : ")
+  check_on_or_off("NS3_MTP" "NS3_MTP")
+
   string(APPEND out "ns-3 Click Integration        : ")
   check_on_or_off("ON" "NS3_CLICK")
 
@@ -379,6 +379,12 @@ macro(process_options)
     add_definitions(-DENABLE_DES_METRICS)
   endif()
 
+  # Shared between all modules, since it changes the layout of the
+  # reference counted classes
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+  endif()
+
   if(${NS3_SANITIZE} AND ${NS3_SANITIZE_MEMORY})
     message(
       FATAL_ERROR
@@ -1150,6 +1156,10 @@ macro(process_options)
   # types
   if(${NS3_LOG} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_LOG_ENABLE)
+    # Compile in only the selected log components and levels
+    if(NOT "${NS3_LOG_COMPONENTS}" STREQUAL "")
+      add_compile_definitions(NS3_LOG_COMPILED="${NS3_LOG_COMPONENTS}")
+    endif()
   endif()
   # Force enable ns-3 asserts in debug builds and if requested for other build
   # types
@@ -1190,6 +1200,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${NS3_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
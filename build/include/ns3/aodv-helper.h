@@ -0,0 +1 @@
+#include "/root/repo/src/aodv/helper/aodv-helper.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wimax/model/bs-service-flow-manager.h"
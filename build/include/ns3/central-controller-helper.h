@@ -0,0 +1 @@
+#include "/root/repo/src/central-controller/helper/central-controller-helper.h"
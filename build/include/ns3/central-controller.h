@@ -0,0 +1 @@
+#include "/root/repo/src/central-controller/model/central-controller.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/shared-memory/model/control-loop-probe.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/eht/default-emlsr-manager.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/energy/helper/energy-source-container.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/core/helper/event-garbage-collector.h"
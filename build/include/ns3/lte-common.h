@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/lte-common.h"
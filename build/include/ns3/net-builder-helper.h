@@ -0,0 +1 @@
+#include "/root/repo/src/net-builder/helper/net-builder-helper.h"
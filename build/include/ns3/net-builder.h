@@ -0,0 +1 @@
+#include "/root/repo/src/net-builder/model/net-builder.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/no-op-handover-algorithm.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/topology-read/model/orbis-topology-reader.h"
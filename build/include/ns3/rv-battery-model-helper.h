@@ -0,0 +1 @@
+#include "/root/repo/src/energy/helper/rv-battery-model-helper.h"
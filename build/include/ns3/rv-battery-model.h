@@ -0,0 +1 @@
+#include "/root/repo/src/energy/model/rv-battery-model.h"
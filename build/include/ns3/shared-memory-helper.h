@@ -0,0 +1 @@
+#include "/root/repo/src/shared-memory/helper/shared-memory-helper.h"
@@ -0,0 +1,10 @@
+#ifdef NS3_MODULE_COMPILATION 
+    error "Do not include ns3 module aggregator headers from other modules these are meant only for end user scripts." 
+#endif 
+#ifndef NS3_MODULE_SHARED_MEMORY
+    // Module headers: 
+    #include <ns3/shared-memory.h>
+    #include <ns3/control-loop-probe.h>
+    #include <ns3/control-loop-event-log.h>
+    #include <ns3/shared-memory-helper.h>
+#endif 
\ No newline at end of file
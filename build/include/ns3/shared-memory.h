@@ -0,0 +1 @@
+#include "/root/repo/src/shared-memory/model/shared-memory.h"
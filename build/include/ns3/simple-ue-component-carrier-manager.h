@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/simple-ue-component-carrier-manager.h"
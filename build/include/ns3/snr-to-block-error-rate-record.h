@@ -0,0 +1 @@
+#include "/root/repo/src/wimax/model/snr-to-block-error-rate-record.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/antenna/utils/symmetric-adjacency-matrix.h"
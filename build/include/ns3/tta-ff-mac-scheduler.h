@@ -0,0 +1 @@
+#include "/root/repo/src/lte/model/tta-ff-mac-scheduler.h"
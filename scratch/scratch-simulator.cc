@@ -77,6 +77,9 @@ runSimulator(std::vector<std::vector<int>> graph, int n, int duration)
 int
 main(int argc, char* argv[])
 {
+    CommandLine cmd(__FILE__);
+    cmd.Parse(argc, argv);
+
     GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
 
     int duration = 600;
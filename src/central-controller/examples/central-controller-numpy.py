@@ -0,0 +1,82 @@
+# -*-  Mode: Python; -*-
+#
+#  SPDX-License-Identifier: GPL-2.0-only
+
+"""
+In-process agent loop on the CentralController arrays, without copies.
+
+The link data (NetBuilder.getLinkStateArrays), the next hop matrix
+(CentralController.getNextHops) and the edge weights
+(CentralController.getEdgeWeights) are std::vector objects whose data()
+is exposed by the bindings as a buffer, so numpy.frombuffer wraps the
+C++ storage directly.  The views stay valid as long as the vectors are
+not resized, i.e. for the lifetime of the topology and controller.
+"""
+
+import sys
+
+try:
+    import numpy as np
+except ModuleNotFoundError:
+    raise SystemExit("Error: this example requires numpy")
+
+try:
+    from ns import ns
+except ModuleNotFoundError:
+    raise SystemExit(
+        "Error: ns3 Python module not found;"
+        " Python bindings may not be enabled"
+        " or your PYTHONPATH might not be properly configured"
+    )
+
+
+def view(vector, dtype, shape):
+    """Wrap a std::vector of primitives as a numpy array, without copying."""
+    data = vector.data()
+    data.reshape((vector.size(),))
+    return np.frombuffer(data, dtype=dtype, count=vector.size()).reshape(shape)
+
+
+def main(argv):
+    width = 4
+    n = width * width
+
+    nb = ns.NetBuilder(n)
+    nb.quadConnect(width)
+    nb.EnableForwardCallback()
+    nb.installReceiveAppForAll(ns.Seconds(0), ns.Seconds(10))
+    nb.installSendToAllApp(0)
+
+    controller = ns.CentralController(nb)
+    controller.InitRoutingTable()
+
+    links = ns.NetBuilder.getLinkStateArrays()
+    send_count = view(links.sendCount, np.int32, (n, n))
+    delay = view(links.delay, np.int64, (n, n))
+    next_hops = view(controller.getNextHops(), np.int32, (n, n))
+    weights = view(controller.getEdgeWeights(), np.int32, (controller.getEdgeCount(),))
+    edges = np.array([(e.first, e.second) for e in nb.getEdges()], dtype=np.int32)
+
+    def agent_round():
+        # weight every link by its mean one-way delay, both directions
+        sent = np.maximum(send_count[edges[:, 0], edges[:, 1]], 1)
+        load = delay[edges[:, 0], edges[:, 1]] // sent
+        weights[:] = np.clip(1 + load // 100, 1, 100)
+        controller.ApplyEdgeWeights()
+        print(
+            "t=%.1fs next hop 0 -> %d: %d"
+            % (ns.Simulator.Now().GetSeconds(), n - 1, next_hops[0, n - 1])
+        )
+
+    # one agent round per simulated second, between two Run() calls
+    for t in range(1, 10):
+        ns.Simulator.Stop(ns.Seconds(1))
+        ns.Simulator.Run()
+        agent_round()
+
+    ns.Simulator.Destroy()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
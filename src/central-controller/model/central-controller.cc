@@ -1,13 +1,26 @@
 #include "central-controller.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace ns3
 {
 
+NS_LOG_COMPONENT_DEFINE("CentralController");
+
 CentralController::CentralController(NetBuilder nb)
 {
     netBuilder = nb;
     m_nodes = nb.getNodes();
     m_adj = nb.getAdj();
+    m_edges = nb.getEdges();
+    m_distances.resize(m_adj.size());
+    m_nextHops.assign(m_adj.size() * m_adj.size(), -1);
+    for (uint32_t id = 0; id < m_edges.size(); id++)
+    {
+        m_edgeIds[edgeKey(m_edges[id].first, m_edges[id].second)] = id;
+        m_edgeWeights.push_back(m_adj[m_edges[id].first][m_edges[id].second]);
+    }
     isAdjReady = true;
 }
 
@@ -19,8 +32,15 @@ CentralController::AddTopologyInfo(std::vector<std::vector<int>> pairs, int len)
     {
         m_adj[pairs[i][0]][pairs[i][1]] = pairs[i][2];
         m_adj[pairs[i][1]][pairs[i][0]] = pairs[i][2];
+        auto id = m_edgeIds.find(edgeKey(pairs[i][0], pairs[i][1]));
+        if (id != m_edgeIds.end())
+        {
+            m_edgeWeights[id->second] = pairs[i][2];
+        }
     }
     isAdjReady = true;
+    // not tracked edge by edge, the next update recomputes every route
+    m_routesValid = false;
 }
 
 // void
@@ -54,17 +74,84 @@ CentralController::doUpdateRoutingTable()
     {
         AddRouteFromStart(i, nodeToIpAddress, Dijkstra(i), isVisit);
     }
+    m_routesValid = true;
+    m_dirtyEdges.clear();
+}
+
+void
+CentralController::doUpdateDirtyRoutes()
+{
+    if (!m_routesValid)
+    {
+        doUpdateRoutingTable();
+        return;
+    }
+    if (m_dirtyEdges.empty())
+    {
+        return;
+    }
+    int n = m_adj.size();
+    std::vector<bool> affected(n, false);
+    for (auto& dirty : m_dirtyEdges)
+    {
+        int u = dirty.first / n;
+        int v = dirty.first % n;
+        for (int s = 0; s < n; s++)
+        {
+            if (!affected[s] && isSourceAffected(s, u, v, dirty.second, m_adj[u][v]))
+            {
+                affected[s] = true;
+            }
+        }
+    }
+    m_dirtyEdges.clear();
+
+    std::vector<Ipv4Address> nodeToIpAddress = netBuilder.getNodeToIpAddress();
+    std::vector<std::vector<bool>> isVisit(n, std::vector<bool>(n, false));
+    for (int s = 0; s < n; s++)
+    {
+        if (affected[s])
+        {
+            clearRoutingTable(s);
+            AddRouteFromStart(s, nodeToIpAddress, Dijkstra(s), isVisit);
+        }
+    }
+}
+
+bool
+CentralController::isSourceAffected(int start, int u, int v, int oldWeight, int newWeight)
+{
+    // Dijkstra settles nodes by (distance, index) and takes the next hop from
+    // the first settled predecessor on a shortest path, so the result from
+    // start can only change if the edge was tight before or is tight (or
+    // shorter) after the change, in either direction
+    const std::vector<int>& d = m_distances[start];
+    if (d.empty())
+    {
+        return true;
+    }
+    auto tight = [&](int a, int b, int w) {
+        return w != -1 && d[a] != m_inf_distance && d[b] != m_inf_distance &&
+               int64_t(d[a]) + w == d[b];
+    };
+    auto shorter = [&](int a, int b, int w) {
+        return w != -1 && d[a] != m_inf_distance && int64_t(d[a]) + w <= d[b];
+    };
+    return tight(u, v, oldWeight) || tight(v, u, oldWeight) || shorter(u, v, newWeight) ||
+           shorter(v, u, newWeight);
 }
 
 void
 CentralController::AddRouteFromStart(int start,
-                                     std::vector<Ipv4Address> nodeToIpAddress,
+                                     const std::vector<Ipv4Address>& nodeToIpAddress,
                                      std::vector<int> nextNodes,
                                      std::vector<std::vector<bool>>& isVisit)
 {
     Ipv4StaticRoutingHelper staticRoutingHelper;
     Ptr<Ipv4StaticRouting> staticRouting =
         staticRoutingHelper.GetStaticRouting(m_nodes.Get(start)->GetObject<Ipv4>());
+    int n = m_adj.size();
+    std::fill(m_nextHops.begin() + start * n, m_nextHops.begin() + (start + 1) * n, -1);
     for (int i = 0; i < nextNodes.size(); i++)
     {
         if (i == start)
@@ -77,6 +164,7 @@ CentralController::AddRouteFromStart(int start,
         {
             staticRouting->AddHostRouteTo(dst, interface);
             isVisit[start][i] = true;
+            m_nextHops[start * n + i] = nextNodes[i];
         }
     }
 }
@@ -86,21 +174,29 @@ CentralController::clearRoutingTable()
 {
     for (int i = 0; i < m_nodes.GetN(); i++)
     {
-        Ipv4StaticRoutingHelper staticRoutingHelper;
-        Ptr<Ipv4StaticRouting> staticRouting =
-            staticRoutingHelper.GetStaticRouting(m_nodes.Get(i)->GetObject<Ipv4>());
-        uint32_t num = staticRouting->GetNRoutes();
-        for (uint32_t j = num-1; j > 0; j--)
+        clearRoutingTable(i);
+    }
+}
+
+void
+CentralController::clearRoutingTable(int node)
+{
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    Ptr<Ipv4StaticRouting> staticRouting =
+        staticRoutingHelper.GetStaticRouting(m_nodes.Get(node)->GetObject<Ipv4>());
+    uint32_t num = staticRouting->GetNRoutes();
+    for (uint32_t j = num-1; j > 0; j--)
+    {
+        std::ostringstream oss;
+        oss << staticRouting->GetRoute(j).GetDestNetwork();
+        std::string dst = oss.str();
+        if (dst[dst.length() - 1] != '0')
         {
-            std::ostringstream oss;
-            oss << staticRouting->GetRoute(j).GetDestNetwork();
-            std::string dst = oss.str();
-            if (dst[dst.length() - 1] != '0')
-            {
-                staticRouting->RemoveRoute(j);
-            }
+            staticRouting->RemoveRoute(j);
         }
     }
+    int n = m_adj.size();
+    std::fill(m_nextHops.begin() + node * n, m_nextHops.begin() + (node + 1) * n, -1);
 }
 
 void
@@ -123,8 +219,26 @@ CentralController::PrintRoutingTable()
 void
 CentralController::UpdateRoutingTable(std::string weightsData)
 {
-    UpdateWeights(weightsData);
-    doUpdateRoutingTable();
+    {
+        NS_CONTROL_LOOP_PROBE(m_probe, UPDATE_WEIGHTS);
+        if (!weightsData.empty() &&
+            (weightsData[0] == WEIGHTS_DELTA || weightsData[0] == WEIGHTS_DENSE))
+        {
+            UpdateWeightsBinary(weightsData);
+        }
+        else
+        {
+            UpdateWeights(weightsData);
+        }
+    }
+    NS_CONTROL_LOOP_PROBE(m_probe, ROUTE_INSTALL);
+    doUpdateDirtyRoutes();
+}
+
+void
+CentralController::SetControlLoopProbe(Ptr<ControlLoopProbe> probe)
+{
+    m_probe = probe;
 }
 
 void
@@ -136,7 +250,7 @@ CentralController::InitRoutingTable()
 void
 CentralController::UpdateWeights(std::string data)
 {
-    std::cout<<"receive:\n"<<data<<std::endl;
+    NS_LOG_DEBUG("receive:\n" << data);
     int startPos = 0;
     int cursor = data.find("/", startPos);
     while (cursor != std::string::npos)
@@ -152,13 +266,123 @@ CentralController::UpdateWeights(std::string data)
         int n0 = atoi(link.substr(0, firstSpace).c_str());
         int n1 = atoi(link.substr(firstSpace + 1, secondSpace - firstSpace - 1).c_str());
         int w = atoi(link.substr(secondSpace + 1).c_str());
-        m_adj[n0][n1] = w;
-        m_adj[n1][n0] = w;
+        setWeight(n0, n1, w);
         startPos = cursor + 1;
         cursor = data.find("/", startPos);
     }
 }
 
+void
+CentralController::UpdateWeightsBinary(const std::string& data)
+{
+    WeightsHeader header;
+    if (data.size() < sizeof(header))
+    {
+        std::cout << "When UpdateWeights, binary header truncated" << std::endl;
+        return;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    const char* records = data.data() + sizeof(header);
+    std::size_t recordSize = header.format == WEIGHTS_DELTA ? sizeof(WeightDelta) : sizeof(int32_t);
+    if (data.size() - sizeof(header) < header.count * recordSize)
+    {
+        std::cout << "When UpdateWeights, binary payload truncated" << std::endl;
+        return;
+    }
+    // the payload is not necessarily aligned, copy the records out
+    if (header.format == WEIGHTS_DELTA)
+    {
+        std::vector<WeightDelta> deltas(header.count);
+        std::memcpy(deltas.data(), records, header.count * recordSize);
+        UpdateWeightsDelta(deltas.data(), header.count);
+    }
+    else
+    {
+        std::vector<int32_t> weights(header.count);
+        std::memcpy(weights.data(), records, header.count * recordSize);
+        UpdateWeightsDense(weights.data(), header.count);
+    }
+}
+
+void
+CentralController::UpdateWeightsDelta(const WeightDelta* deltas, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (deltas[i].edgeId >= m_edges.size())
+        {
+            std::cout << "When UpdateWeights, unknown edge " << deltas[i].edgeId << std::endl;
+            continue;
+        }
+        const std::pair<int, int>& edge = m_edges[deltas[i].edgeId];
+        setWeight(edge.first, edge.second, deltas[i].weight);
+    }
+}
+
+void
+CentralController::UpdateWeightsDense(const int32_t* weights, uint32_t n)
+{
+    if (n != m_edges.size())
+    {
+        std::cout << "When UpdateWeights, got " << n << " weights for " << m_edges.size()
+                  << " edges" << std::endl;
+    }
+    for (uint32_t id = 0; id < n && id < m_edges.size(); id++)
+    {
+        setWeight(m_edges[id].first, m_edges[id].second, weights[id]);
+    }
+}
+
+void
+CentralController::setWeight(int n0, int n1, int w)
+{
+    if (m_adj[n0][n1] == w)
+    {
+        return;
+    }
+    // keep the weight the installed routes were computed with
+    m_dirtyEdges.emplace(edgeKey(n0, n1), m_adj[n0][n1]);
+    m_adj[n0][n1] = w;
+    m_adj[n1][n0] = w;
+    auto id = m_edgeIds.find(edgeKey(n0, n1));
+    if (id != m_edgeIds.end())
+    {
+        m_edgeWeights[id->second] = w;
+    }
+}
+
+uint64_t
+CentralController::edgeKey(int n0, int n1)
+{
+    return uint64_t(std::min(n0, n1)) * m_adj.size() + std::max(n0, n1);
+}
+
+const std::vector<int32_t>&
+CentralController::getNextHops()
+{
+    return m_nextHops;
+}
+
+std::vector<int32_t>&
+CentralController::getEdgeWeights()
+{
+    return m_edgeWeights;
+}
+
+void
+CentralController::ApplyEdgeWeights()
+{
+    // m_edgeWeights already holds the new values, m_adj still the old ones
+    UpdateWeightsDense(m_edgeWeights.data(), m_edgeWeights.size());
+    doUpdateDirtyRoutes();
+}
+
+int
+CentralController::getEdgeCount()
+{
+    return m_edges.size();
+}
+
 std::string
 CentralController::ConcatLinkState(int i, int j, LinkState linkState)
 {
@@ -178,7 +402,7 @@ std::string
 CentralController::CollectNetInfo()
 {
     std::string result;
-    std::vector<std::vector<LinkState>> linkStates = netBuilder.getLinkStates();
+    const LinkStateArrays& linkStates = NetBuilder::getLinkStateArrays();
     for (int i = 0; i < m_adj.size(); i++)
     {
         for (int j = 0; j < m_adj.size(); j++)
@@ -187,7 +411,7 @@ CentralController::CollectNetInfo()
             {
                 continue;
             }
-            std::string linkInfo = ConcatLinkState(i, j, linkStates[i][j]);
+            std::string linkInfo = ConcatLinkState(i, j, linkStates.get(i, j));
             result.append(linkInfo);
         }
     }
@@ -212,7 +436,9 @@ CentralController::Dijkstra(int start)
     }
     // nextNodes[i]: 在从start到i的最短路径中，start之后的下一跳节点的标号
     std::vector<int> nextNodes(n, 0);
-    std::vector<int> distance2start(n, m_max_weight);
+    // m_max_weight bounds a single link, not a path: long paths in large
+    // grids easily exceed it, so unreached nodes start at m_inf_distance
+    std::vector<int> distance2start(n, m_inf_distance);
     std::vector<int> isCheck(n, 0);
     // init
     distance2start[start] = 0;
@@ -224,7 +450,7 @@ CentralController::Dijkstra(int start)
         findNeighbors(start, cursor, distance2start, nextNodes, isCheck);
         // find the shortest one whitch is unchecked
         int index = -1;
-        int min = m_max_weight;
+        int min = m_inf_distance;
         for (int j = 0; j < n; j++)
         {
             if (isCheck[j] == 1)
@@ -239,12 +465,14 @@ CentralController::Dijkstra(int start)
         }
         if (index == -1)
         {
+            m_distances[start].clear();
             std::cout << "err occurred when find the shortest one" << std::endl;
             return std::vector<int>();
         }
         isCheck[index] = 1;
         cursor = index;
     }
+    m_distances[start] = distance2start;
     return nextNodes;
 }
 
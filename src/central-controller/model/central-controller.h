@@ -2,6 +2,7 @@
 #define CENTRAL_CONTROLLER_H
 
 #include "ns3/applications-module.h"
+#include "ns3/control-loop-probe.h"
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/ipv4-list-routing-helper.h"
@@ -10,7 +11,9 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 
+#include <limits>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 // Add a doxygen group for this module.
@@ -19,6 +22,8 @@
  * @defgroup central-controller Description of the central-controller
  */
 
+class CentralControllerBench;
+
 namespace ns3
 {
 
@@ -28,22 +33,66 @@ namespace ns3
 class CentralController
 {
   public:
+    // Binary weight updates. The payload starts with a WeightsHeader whose
+    // format is WEIGHTS_DELTA or WEIGHTS_DENSE, followed by count records:
+    // WeightDelta for a delta list, int32_t weights indexed by edge id for a
+    // dense vector. Edge ids are the NetBuilder connection order (getEdges),
+    // all fields are in host byte order.
+    static const uint8_t WEIGHTS_DELTA = 0x01;
+    static const uint8_t WEIGHTS_DENSE = 0x02;
+
+    struct WeightsHeader
+    {
+        uint8_t format;
+        uint8_t reserved[3];
+        uint32_t count;
+    };
+
+    struct WeightDelta
+    {
+        uint32_t edgeId;
+        int32_t weight;
+    };
+
     CentralController(NetBuilder nb);
     void AddTopologyInfo(std::vector<std::vector<int>> pairs, int len);
     std::string CollectNetInfo();
+    // weightsData is either the text list "i j w/i j w/..." or a binary
+    // payload (see WeightsHeader); only the routes of the sources whose
+    // shortest paths may cross a changed edge are recomputed
     void UpdateRoutingTable(std::string weightsData);
+    // O(n) in the number of deltas, marks the changed edges dirty
+    void UpdateWeightsDelta(const WeightDelta* deltas, uint32_t n);
+    // weights[id] is the new weight of edge id, marks the changed edges dirty
+    void UpdateWeightsDense(const int32_t* weights, uint32_t n);
+    int getEdgeCount();
+    // Live arrays for in-process agents, e.g. wrapped by NumPy without
+    // copying through the Python bindings.
+    // getNextHops()[i * n + j]: next hop from node i towards node j, -1 if none
+    const std::vector<int32_t>& getNextHops();
+    // getEdgeWeights()[id]: weight of edge id; may be written in place,
+    // then ApplyEdgeWeights() marks the changed edges dirty and updates routes
+    std::vector<int32_t>& getEdgeWeights();
+    void ApplyEdgeWeights();
     void InitRoutingTable();
     void PrintRoutingTable();
+    // record UpdateWeights and route installation into probe, may be null
+    void SetControlLoopProbe(Ptr<ControlLoopProbe> probe);
 
   private:
+    friend class ::CentralControllerBench; // utils/bench-central-controller.cc
+
     // void CollectLinkInfo();
 
     void doUpdateRoutingTable();
+    void doUpdateDirtyRoutes();
+    bool isSourceAffected(int start, int u, int v, int oldWeight, int newWeight);
     void AddRouteFromStart(int start,
-                           std::vector<Ipv4Address> nodeToIpAddress,
+                           const std::vector<Ipv4Address>& nodeToIpAddress,
                            std::vector<int> path,
                            std::vector<std::vector<bool>>& isVisit);
     void clearRoutingTable();
+    void clearRoutingTable(int node);
     void findNeighbors(int start,
                        int v,
                        std::vector<int>& distance2start,
@@ -51,6 +100,9 @@ class CentralController
                        std::vector<int> isCheck);
     std::vector<int> Dijkstra(int start);
     void UpdateWeights(std::string weightsData);
+    void UpdateWeightsBinary(const std::string& data);
+    void setWeight(int n0, int n1, int w);
+    uint64_t edgeKey(int n0, int n1);
     std::string ConcatLinkState(int i, int j, LinkState linkState);
 
     NodeContainer m_nodes;
@@ -59,9 +111,22 @@ class CentralController
     EventId m_collectionEvent;
     EventId m_routingUpdateEvent;
     int m_max_weight = 101;
+    int m_inf_distance = std::numeric_limits<int>::max();
     NetBuilder netBuilder;
     std::vector<std::vector<int>> m_adj;
     bool isAdjReady = false;
+    Ptr<ControlLoopProbe> m_probe;
+    std::vector<std::pair<int, int>> m_edges;
+    // edge key (min * n + max) -> edge id
+    std::unordered_map<uint64_t, uint32_t> m_edgeIds;
+    std::vector<int32_t> m_edgeWeights;
+    std::vector<int32_t> m_nextHops;
+    // m_distances[s]: shortest distances from s when its routes were installed
+    std::vector<std::vector<int>> m_distances;
+    // the installed routes match m_adj except for m_dirtyEdges
+    bool m_routesValid = false;
+    // edge key (min * n + max) -> weight when the routes were installed
+    std::unordered_map<uint64_t, int> m_dirtyEdges;
 };
 
 } // namespace ns3
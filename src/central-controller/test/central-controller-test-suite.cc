@@ -4,6 +4,9 @@
 // An essential include is test.h
 #include "ns3/test.h"
 
+#include <cstring>
+#include <set>
+
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
@@ -56,6 +59,160 @@ CentralControllerTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * @ingroup central-controller-tests
+ * Check that text, binary delta and dense weight updates only recompute
+ * the routes they affect, and that the result matches a full update.
+ */
+class CentralControllerWeightUpdateTestCase : public TestCase
+{
+  public:
+    CentralControllerWeightUpdateTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @param nodes The nodes.
+     * @return Every host route of every node, as "node dst interface".
+     */
+    std::set<std::string> GetRoutes(NodeContainer nodes);
+    /**
+     * @param nb The topology.
+     * @param from The source node.
+     * @param to The destination node.
+     * @return The output interface of the host route from \p from to \p to.
+     */
+    int GetInterface(NetBuilder& nb, int from, int to);
+};
+
+CentralControllerWeightUpdateTestCase::CentralControllerWeightUpdateTestCase()
+    : TestCase("CentralController sparse weight updates")
+{
+}
+
+std::set<std::string>
+CentralControllerWeightUpdateTestCase::GetRoutes(NodeContainer nodes)
+{
+    std::set<std::string> routes;
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Ipv4StaticRouting> staticRouting =
+            staticRoutingHelper.GetStaticRouting(nodes.Get(i)->GetObject<Ipv4>());
+        for (uint32_t j = 0; j < staticRouting->GetNRoutes(); j++)
+        {
+            Ipv4RoutingTableEntry route = staticRouting->GetRoute(j);
+            std::ostringstream oss;
+            oss << i << " " << route.GetDest() << " " << route.GetInterface();
+            routes.insert(oss.str());
+        }
+    }
+    return routes;
+}
+
+int
+CentralControllerWeightUpdateTestCase::GetInterface(NetBuilder& nb, int from, int to)
+{
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    Ptr<Ipv4StaticRouting> staticRouting =
+        staticRoutingHelper.GetStaticRouting(nb.getNodes().Get(from)->GetObject<Ipv4>());
+    Ipv4Address dst = nb.getNodeToIpAddress()[to];
+    for (uint32_t j = 0; j < staticRouting->GetNRoutes(); j++)
+    {
+        if (staticRouting->GetRoute(j).GetDest() == dst)
+        {
+            return staticRouting->GetRoute(j).GetInterface();
+        }
+    }
+    return -1;
+}
+
+void
+CentralControllerWeightUpdateTestCase::DoRun()
+{
+    // 0 - 1
+    // |   |
+    // 2 - 3
+    NetBuilder nb(4);
+    nb.connect({{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+    CentralController controller(nb);
+    controller.InitRoutingTable();
+    NS_TEST_ASSERT_MSG_EQ(controller.getEdgeCount(), 4, "one edge id per link");
+
+    // binary delta: make 0-1 expensive, 0 reaches 3 through 2
+    CentralController::WeightsHeader header{CentralController::WEIGHTS_DELTA, {0, 0, 0}, 1};
+    CentralController::WeightDelta delta{0, 50};
+    std::string payload(sizeof(header) + sizeof(delta), '\0');
+    std::memcpy(payload.data(), &header, sizeof(header));
+    std::memcpy(payload.data() + sizeof(header), &delta, sizeof(delta));
+    controller.UpdateRoutingTable(payload);
+    NS_TEST_ASSERT_MSG_EQ(GetInterface(nb, 0, 3), nb.getPort(0, 2), "delta applied");
+
+    // dense vector: make 0-2 expensive and 0-1 cheap again
+    std::vector<int32_t> weights = {1, 50, 1, 1};
+    header = {CentralController::WEIGHTS_DENSE, {0, 0, 0}, 4};
+    payload.assign(sizeof(header) + weights.size() * sizeof(int32_t), '\0');
+    std::memcpy(payload.data(), &header, sizeof(header));
+    std::memcpy(payload.data() + sizeof(header), weights.data(), weights.size() * sizeof(int32_t));
+    controller.UpdateRoutingTable(payload);
+    NS_TEST_ASSERT_MSG_EQ(GetInterface(nb, 0, 3), nb.getPort(0, 1), "dense vector applied");
+
+    // the array views follow the updates, and writes to them are applied
+    NS_TEST_ASSERT_MSG_EQ(controller.getEdgeWeights()[1], 50, "edge weight view");
+    NS_TEST_ASSERT_MSG_EQ(controller.getNextHops()[0 * 4 + 3], 1, "next hop view");
+    controller.getEdgeWeights()[0] = 90;
+    controller.ApplyEdgeWeights();
+    NS_TEST_ASSERT_MSG_EQ(controller.getNextHops()[0 * 4 + 3], 2, "edge weight write applied");
+    NS_TEST_ASSERT_MSG_EQ(GetInterface(nb, 0, 3), nb.getPort(0, 2), "routes follow the view");
+    controller.getEdgeWeights()[0] = 1;
+    controller.ApplyEdgeWeights();
+    NS_TEST_ASSERT_MSG_EQ(controller.getNextHops()[0 * 4 + 3], 1, "edge weight restored");
+
+    // text list, and an incremental update must match a full one
+    controller.UpdateRoutingTable("1 3 80/2 3 2/");
+    NS_TEST_ASSERT_MSG_EQ(GetInterface(nb, 0, 3), nb.getPort(0, 2), "text list applied");
+    std::set<std::string> incremental = GetRoutes(nb.getNodes());
+    controller.InitRoutingTable();
+    NS_TEST_ASSERT_MSG_EQ((incremental == GetRoutes(nb.getNodes())),
+                          true,
+                          "incremental update differs from a full update");
+
+    Simulator::Destroy();
+
+    // random deltas on a grid, compared with a full update every round
+    NetBuilder grid(36);
+    grid.quadConnect(6);
+    CentralController gridController(grid);
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    std::vector<int32_t> gridWeights(gridController.getEdgeCount());
+    for (auto& w : gridWeights)
+    {
+        w = rv->GetInteger(1, 100);
+    }
+    gridController.UpdateWeightsDense(gridWeights.data(), gridWeights.size());
+    gridController.InitRoutingTable();
+    for (int round = 0; round < 10; round++)
+    {
+        std::vector<CentralController::WeightDelta> deltas;
+        for (int k = 0; k < 3; k++)
+        {
+            deltas.push_back({rv->GetInteger(0, gridController.getEdgeCount() - 1),
+                              int32_t(rv->GetInteger(1, 100))});
+        }
+        gridController.UpdateWeightsDelta(deltas.data(), deltas.size());
+        gridController.UpdateRoutingTable("");
+        incremental = GetRoutes(grid.getNodes());
+        gridController.InitRoutingTable();
+        NS_TEST_ASSERT_MSG_EQ((incremental == GetRoutes(grid.getNodes())),
+                              true,
+                              "incremental update differs from a full update in round "
+                                  << round);
+    }
+
+    Simulator::Destroy();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -75,6 +232,7 @@ CentralControllerTestSuite::CentralControllerTestSuite()
 {
     // Duration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new CentralControllerTestCase1, TestCase::Duration::QUICK);
+    AddTestCase(new CentralControllerWeightUpdateTestCase, TestCase::Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -147,6 +147,31 @@ const char* NS_GLOBAL_VALUE = "name=value[;...]";
  */
 const char* NS_LOG = "component=option[|option...][:...]";
 
+/**
+ * @ingroup core-environ
+ * @brief Write the log messages to a binary file.
+ *
+ * Open the ns3::LogBinarySink at startup, so the enabled log messages
+ * are encoded in binary and written to \pname{file} by a background
+ * thread, instead of being formatted to \c std::clog.  Decode the
+ * file with the \c log-binary-to-text program in \c utils.
+ *
+ * <dl class="params">
+ *   <dt>%Parameters</dt>
+ *   <dd>
+ *     <table class="params">
+ *       <tr>
+ *         <td class="paramname">file</td>
+ *         <td>The binary log file to write.</td>
+ *       </tr>
+ *     </table>
+ *   </dd>
+ * </dl>
+ *
+ * Referenced by ns3::LogBinarySinkInit.
+ */
+const char* NS_LOG_BINARY = "file";
+
 /**
  * @ingroup core-environ
  * @brief Where to make temporary directories.
@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+
+/**
+ * @file
+ * @ingroup checkpoint
+ * ns3::Checkpoint declarations.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup simulator
+ * @defgroup checkpoint Checkpoint and branch
+ * @brief Continue a simulation from a point reached earlier.
+ *
+ * The events of a simulation hold arbitrary callbacks, bound to objects
+ * by pointer, so the simulation state cannot be written out generically.
+ * The functions here take the checkpoint at the process level instead:
+ * the process is forked, and the copy holds the complete state of the
+ * simulation (events, nodes, devices, queues, random variable streams
+ * and all the model variables) as it was at the checkpoint.  Continuing
+ * from the copy is bit-identical to continuing from the original, and
+ * takes no time at all.
+ *
+ * Forking copies only the calling thread, so these functions are
+ * available only with the DefaultSimulatorImpl, and with no other
+ * threads running (such as the DesMetrics binary trace writer, or the
+ * reader threads of the emulation devices).  The checkpoints are kept in
+ * memory, as processes: they do not survive the host.
+ *
+ * They are implemented on POSIX systems only.
+ */
+
+/**
+ * @ingroup checkpoint
+ * @brief Namespace for the checkpoint functions.
+ */
+namespace Checkpoint
+{
+
+/**
+ * @ingroup checkpoint
+ * Branch the simulation into \p n simulations continuing from the
+ * current state, for instance to compare what-if changes.
+ *
+ * Each branch is a process, which continues from here with its own
+ * branch index: the calling process has index 0, and should wait for
+ * the others with WaitBranches().  The other branches should end with
+ * \c std::exit() or \c _exit(), after writing their results out.
+ *
+ * This can be called from an event, with Simulator::Schedule().
+ *
+ * @param [in] n The number of branches, including the calling process.
+ * @returns The index of the branch, from 0 to \p n - 1.
+ */
+uint32_t Branch(uint32_t n);
+
+/**
+ * @ingroup checkpoint
+ * Wait for the branches created by Branch() to end.
+ *
+ * @returns The number of branches which did not exit with status 0.
+ */
+uint32_t WaitBranches();
+
+/**
+ * @ingroup checkpoint
+ * Save the current state of the simulation, to restore it if the
+ * process dies.
+ *
+ * The checkpoint is a process waiting for the calling one to end.  If
+ * the calling process ends normally, by returning from \c main() or with
+ * \c std::exit(), the checkpoint ends too.  If it dies (a signal, an
+ * abort, an \c _exit(), an out of memory kill), the checkpoint is
+ * restored: it continues from here, and Save() returns \c true in it.
+ * A new checkpoint replaces the previous one.
+ *
+ * This can be called from an event, with Simulator::Schedule(), for
+ * instance every few minutes of simulation time.
+ *
+ * @returns \c false in the calling process, \c true in the restored
+ *          checkpoint.
+ */
+bool Save();
+
+/**
+ * @ingroup checkpoint
+ * Get the number of times the simulation was restored from a checkpoint
+ * taken by Save().
+ *
+ * @returns The number of restores.
+ */
+uint32_t GetRestoreCount();
+
+} // namespace Checkpoint
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
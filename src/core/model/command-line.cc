@@ -13,6 +13,7 @@
 #include "environment-variable.h"
 #include "global-value.h"
 #include "log.h"
+#include "startup-profile.h"
 #include "string.h"
 #include "system-path.h"
 #include "type-id.h"
@@ -284,6 +285,12 @@ CommandLine::HandleHardOptions(const std::vector<std::string>& args) const
             PrintVersion(std::cout);
             std::exit(0);
         }
+        else if (name == "PrintStartupProfile" || name == "startup-profile")
+        {
+            // method below never returns.
+            StartupProfile::Print(std::cout);
+            std::exit(0);
+        }
         else if (name == "PrintGroups")
         {
             // method below never returns.
@@ -425,6 +432,7 @@ CommandLine::PrintHelp(std::ostream& os) const
        << "    --PrintGroup=[group]:        Print all TypeIds of group.\n"
        << "    --PrintTypeIds:              Print all TypeIds.\n"
        << "    --PrintAttributes=[typeid]:  Print all attributes of typeid.\n"
+       << "    --PrintStartupProfile:       Print where the startup time went.\n"
        << "    --PrintVersion:              Print the ns-3 version.\n"
        << "    --PrintHelp:                 Print this help message.\n"
        << std::endl;
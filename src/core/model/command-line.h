@@ -57,10 +57,12 @@ namespace ns3
    --PrintGroup=[group]:        Print all TypeIds of group.
    --PrintTypeIds:              Print all TypeIds.
    --PrintAttributes=[typeid]:  Print all attributes of typeid.
+   --PrintStartupProfile:       Print where the startup time went.
    --PrintVersion:              Print the ns-3 version.
    --PrintHelp:                 Print this help message. \endverbatim
  *
- * The more common \c \--version is a synonym for \c \--PrintVersion.
+ * The more common \c \--version is a synonym for \c \--PrintVersion,
+ * and \c \--startup-profile for \c \--PrintStartupProfile (see StartupProfile).
  *
  * The more common \c \--help is a synonym for \c \--PrintHelp; an example
  * is given below.
@@ -180,6 +182,7 @@ namespace ns3
        --PrintGroup=[group]:        Print all TypeIds of group.
        --PrintTypeIds:              Print all TypeIds.
        --PrintAttributes=[typeid]:  Print all attributes of typeid.
+       --PrintStartupProfile:       Print where the startup time went.
        --PrintVersion:              Print the ns-3 version.
        --PrintHelp:                 Print this help message. \endverbatim
  *
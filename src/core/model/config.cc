@@ -15,6 +15,9 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <algorithm>
+#include <map>
+#include <numeric>
 #include <sstream>
 
 /**
@@ -190,6 +193,8 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * @ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into index ranges.
  */
 class ArrayMatcher
 {
@@ -207,8 +212,21 @@ class ArrayMatcher
      * @returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Get the indices matching the Config path, among the first \p n.
+     *
+     * @param [in] n The number of indices.
+     * @returns The matching indices, in increasing order.
+     */
+    std::vector<std::size_t> GetMatches(std::size_t n) const;
 
   private:
+    /**
+     * Parse a Config path specification, or one of its alternatives.
+     *
+     * @param [in] element The Config path specification.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -219,77 +237,109 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** Whether the element is, or has an alternative, "*". */
+    bool m_all;
+    /** The inclusive ranges of the matching indices. */
+    std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_all(false)
 {
     NS_LOG_FUNCTION(this << element);
+    Parse(element);
+    std::sort(m_ranges.begin(), m_ranges.end());
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string element)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
     {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
+        m_all = true;
+        return;
     }
     std::string::size_type tmp;
-    tmp = m_element.find('|');
+    tmp = element.find('|');
     if (tmp != std::string::npos)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
-        }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        Parse(element.substr(0, tmp - 0));
+        Parse(element.substr(tmp + 1, element.size() - (tmp + 1)));
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
         dash < rightBracket)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
         uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && min <= max)
         {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            m_ranges.emplace_back(min, max);
         }
+        return;
     }
     uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (StringToUint32(element, &value))
+    {
+        m_ranges.emplace_back(value, value);
+    }
+}
+
+bool
+ArrayMatcher::Matches(std::size_t i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    if (m_all)
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+        NS_LOG_DEBUG("Array " << i << " matches *");
         return true;
     }
+    for (const auto& range : m_ranges)
+    {
+        if (i >= range.first && i <= range.second)
+        {
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+            return true;
+        }
+    }
     NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
     return false;
 }
 
+std::vector<std::size_t>
+ArrayMatcher::GetMatches(std::size_t n) const
+{
+    NS_LOG_FUNCTION(this << n);
+    std::vector<std::size_t> matches;
+    if (m_all)
+    {
+        matches.resize(n);
+        std::iota(matches.begin(), matches.end(), 0);
+        return matches;
+    }
+    // the ranges are sorted, but may overlap
+    std::size_t next = 0;
+    for (const auto& range : m_ranges)
+    {
+        for (std::size_t i = std::max<std::size_t>(next, range.first);
+             i <= range.second && i < n;
+             ++i)
+        {
+            matches.push_back(i);
+        }
+        next = std::max<std::size_t>(next, std::size_t(range.second) + 1);
+    }
+    return matches;
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -303,6 +353,11 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 /**
  * @ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is split into its elements once, and the attributes
+ * an element refers to are looked up once for each TypeId, so that the
+ * cost of a resolution grows linearly with the number of objects it
+ * visits.
  */
 class Resolver
 {
@@ -326,23 +381,58 @@ class Resolver
     void Resolve(Ptr<Object> root);
 
   private:
+    /** An element of the Config path. */
+    struct Element
+    {
+        /**
+         * Constructor.
+         *
+         * @param [in] item The element.
+         */
+        Element(const std::string& item);
+
+        std::string item;     //!< The element.
+        ArrayMatcher matcher; //!< The element as an array index specification.
+        bool hasTid;          //!< Whether \c tid has been looked up.
+        TypeId tid;           //!< The TypeId of a "$" element.
+    };
+
+    /** An attribute matching an element of the Config path. */
+    struct AttributeMatch
+    {
+        std::string name; //!< The attribute name.
+        bool isContainer; //!< Whether the attribute is a container, or a pointer.
+        /** The accessor of a container, if it is an ObjectPtrContainerAccessor. */
+        const ObjectPtrContainerAccessor* accessor;
+    };
+
     /** Ensure the Config path starts and ends with a '/'. */
     void Canonicalize();
     /**
      * Parse the next element in the Config path.
      *
-     * @param [in] path The remaining portion of the Config path.
+     * @param [in] element The index of the element in the Config path.
      * @param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t element, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * @param [in] path The remaining Config path.
-     * @param [in,out] vector The resulting list of matching objects.
+     * @param [in] element The index of the element in the Config path.
+     * @param [in] root The object holding the container.
+     * @param [in] match The container attribute.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t element, Ptr<Object> root, const AttributeMatch& match);
+    /**
+     * Get the attributes of a TypeId matching an element of the Config
+     * path, pointers and containers of objects only.
+     *
+     * @param [in] element The index of the element in the Config path.
+     * @param [in] tid The TypeId.
+     * @returns The matching attributes.
+     */
+    const std::vector<AttributeMatch>& GetAttributeMatches(std::size_t element, TypeId tid);
     /**
      * Handle one object found on the path.
      *
@@ -367,14 +457,33 @@ class Resolver
     std::vector<std::string> m_workStack;
     /** The Config path. */
     std::string m_path;
+    /** The elements of the Config path. */
+    std::vector<Element> m_elements;
+    /** The attributes matching the elements, by element index and TypeId uid. */
+    std::map<std::pair<std::size_t, uint16_t>, std::vector<AttributeMatch>> m_attributes;
 
 }; // class Resolver
 
+Resolver::Element::Element(const std::string& item)
+    : item(item),
+      matcher(item),
+      hasTid(false)
+{
+}
+
 Resolver::Resolver(std::string path)
     : m_path(path)
 {
     NS_LOG_FUNCTION(this << path);
     Canonicalize();
+
+    std::string::size_type start = 1;
+    std::string::size_type next;
+    while ((next = m_path.find('/', start)) != std::string::npos)
+    {
+        m_elements.emplace_back(m_path.substr(start, next - start));
+        start = next + 1;
+    }
 }
 
 Resolver::~Resolver()
@@ -407,7 +516,7 @@ Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
@@ -432,14 +541,53 @@ Resolver::DoResolveOne(Ptr<Object> object)
     DoOne(object, GetResolvedPath());
 }
 
+const std::vector<Resolver::AttributeMatch>&
+Resolver::GetAttributeMatches(std::size_t element, TypeId tid)
+{
+    NS_LOG_FUNCTION(this << element << tid);
+    auto [it, inserted] = m_attributes.try_emplace({element, tid.GetUid()});
+    if (!inserted)
+    {
+        return it->second;
+    }
+
+    const std::string& item = m_elements[element].item;
+    TypeId nextTid = tid;
+    do
+    {
+        tid = nextTid;
+        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            TypeId::AttributeInformation info = tid.GetAttribute(i);
+            if (info.name != item && item != "*")
+            {
+                continue;
+            }
+            if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) != nullptr)
+            {
+                it->second.push_back({info.name, false, nullptr});
+            }
+            if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)) !=
+                nullptr)
+            {
+                const auto accessor =
+                    dynamic_cast<const ObjectPtrContainerAccessor*>(PeekPointer(info.accessor));
+                it->second.push_back({info.name, true, accessor});
+            }
+            // this could be anything else and we don't know what to do with it.
+            // So, we just ignore it.
+        }
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
+    return it->second;
+}
+
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t element, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << element << root);
 
-    if (next == std::string::npos)
+    if (element == m_elements.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -455,8 +603,8 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    Element& current = m_elements[element];
+    const std::string& item = current.item;
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -467,11 +615,10 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     //
     if (!root)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        if (item.compare(0, 5, "Names") == 0)
         {
             m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
+            DoResolve(element + 1, root);
             m_workStack.pop_back();
             return;
         }
@@ -488,7 +635,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
         m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
+        DoResolve(element + 1, namedObject);
         m_workStack.pop_back();
         return;
     }
@@ -508,106 +655,96 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     if (dollarPos == 0)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
-        Ptr<Object> object = root->GetObject<Object>(tid);
+        if (!current.hasTid)
+        {
+            current.tid = TypeId::LookupByName(item.substr(1, item.size() - 1));
+            current.hasTid = true;
+        }
+        NS_LOG_DEBUG("GetObject=" << current.tid.GetName() << " on path=" << GetResolvedPath());
+        Ptr<Object> object = root->GetObject<Object>(current.tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << current.tid.GetName()
+                                       << ") failed on path=" << GetResolvedPath());
             return;
         }
         m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
+        DoResolve(element + 1, object);
         m_workStack.pop_back();
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
-        bool foundMatch = false;
-
-        do
+        const std::vector<AttributeMatch>& matches =
+            GetAttributeMatches(element, root->GetInstanceTypeId());
+        if (matches.empty())
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            NS_LOG_DEBUG("Requested item=" << item
+                                           << " does not exist on path=" << GetResolvedPath());
+            return;
+        }
+        for (const auto& match : matches)
+        {
+            if (!match.isContainer)
             {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << match.name
+                                                  << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                root->GetAttribute(match.name, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const auto pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const auto vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                m_workStack.push_back(match.name);
+                DoResolve(element + 1, object);
+                m_workStack.pop_back();
+            }
+            else
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << match.name
+                                                     << " on path=" << GetResolvedPath());
+                m_workStack.push_back(match.name);
+                DoArrayResolve(element + 1, root, match);
+                m_workStack.pop_back();
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
-
-        if (!foundMatch)
-        {
-            NS_LOG_DEBUG("Requested item=" << item
-                                           << " does not exist on path=" << GetResolvedPath());
-            return;
         }
     }
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t element, Ptr<Object> root, const AttributeMatch& match)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << element << root << match.name);
+    if (element == m_elements.size())
     {
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const ArrayMatcher& matcher = m_elements[element].matcher;
+
+    const ObjectPtrContainerAccessor* accessor = match.accessor;
+    std::size_t n;
+    if (accessor != nullptr && accessor->IndexIsPosition() &&
+        accessor->GetN(PeekPointer(root), &n))
+    {
+        // look up the matching objects only, not the whole container
+        for (std::size_t i : matcher.GetMatches(n))
+        {
+            std::size_t index;
+            Ptr<Object> object = accessor->GetItem(PeekPointer(root), i, &index);
+            m_workStack.push_back(std::to_string(index));
+            DoResolve(element + 1, object);
+            m_workStack.pop_back();
+        }
+        return;
+    }
 
-    ArrayMatcher matcher = ArrayMatcher(item);
+    ObjectPtrContainerValue container;
+    root->GetAttribute(match.name, container);
     ObjectPtrContainerValue::Iterator it;
     for (it = container.Begin(); it != container.End(); ++it)
     {
@@ -616,7 +753,7 @@ Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& contai
             std::ostringstream oss;
             oss << (*it).first;
             m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
+            DoResolve(element + 1, (*it).second);
             m_workStack.pop_back();
         }
     }
@@ -9,11 +9,18 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "boolean.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
+#include "uinteger.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <limits>
 
 /**
  * @file
@@ -37,11 +44,39 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("ProfileInterval",
+                                          "Time one event in every ProfileInterval, on average, "
+                                          "and report where the time goes at Destroy(); "
+                                          "zero disables the profiler",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_profileInterval),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("ProfileTopN",
+                                          "Number of lines in each table of the profile report",
+                                          UintegerValue(20),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_profileTopN),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("ProfileFile",
+                                          "File to write the profile to in the folded stack "
+                                          "format of the flame graph tools, if not empty",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_profileFile),
+                                          MakeStringChecker())
+                            .AddAttribute("BatchEvents",
+                                          "Remove all the events with the next time stamp from "
+                                          "the scheduler in one call and run them in a row",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&DefaultSimulatorImpl::m_batchEvents),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY),
+      m_eventsWithContextOverflowing(false)
 {
     NS_LOG_FUNCTION(this);
     m_stop = false;
@@ -51,8 +86,9 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
     m_mainThreadId = std::this_thread::get_id();
+    m_profileCountdown = std::numeric_limits<uint64_t>::max();
+    m_batchNext = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl()
@@ -89,6 +125,21 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+
+    if (m_profiler.GetSampleCount() > 0)
+    {
+        m_profiler.Report(std::clog, m_profileTopN);
+        if (!m_profileFile.empty())
+        {
+            std::ofstream file(m_profileFile);
+            m_profiler.WriteFlameGraph(file);
+            if (!file)
+            {
+                NS_LOG_WARN("Cannot write the event profile to " << m_profileFile);
+            }
+        }
+        m_profiler.Clear();
+    }
 }
 
 void
@@ -118,8 +169,32 @@ DefaultSimulatorImpl::GetSystemId() const
 void
 DefaultSimulatorImpl::ProcessOneEvent()
 {
-    Scheduler::Event next = m_events->RemoveNext();
+    InvokeEvent(m_events->RemoveNext());
+}
+
+void
+DefaultSimulatorImpl::ProcessEventBatch()
+{
+    m_events->RemoveNextBatch(m_batch);
+    m_batchNext = 0;
+    while (m_batchNext < m_batch.size() && !m_stop)
+    {
+        // a copy, as the event may remove later events from the batch
+        Scheduler::Event next = m_batch[m_batchNext++];
+        InvokeEvent(next);
+    }
+    // events left over by Simulator::Stop() wait for the next Run()
+    for (; m_batchNext < m_batch.size(); ++m_batchNext)
+    {
+        m_events->Insert(m_batch[m_batchNext]);
+    }
+    m_batch.clear();
+    m_batchNext = 0;
+}
 
+void
+DefaultSimulatorImpl::InvokeEvent(const Scheduler::Event& next)
+{
     PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
 
     NS_ASSERT(next.key.m_ts >= m_currentTs);
@@ -130,7 +205,19 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (--m_profileCountdown == 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        next.impl->Invoke();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+        m_profiler.Record(typeid(*next.impl), next.key.m_context, ns.count());
+        m_profileCountdown = m_profiler.NextGap();
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -139,39 +226,50 @@ DefaultSimulatorImpl::ProcessOneEvent()
 bool
 DefaultSimulatorImpl::IsFinished() const
 {
-    return m_events->IsEmpty() || m_stop;
+    return (m_events->IsEmpty() && m_batchNext == m_batch.size()) || m_stop;
 }
 
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    EventWithContext event;
+    while (m_eventsWithContext.Pop(event))
     {
-        return;
+        InsertEventWithContext(event);
     }
 
-    // swap queues
+    // the overflow list holds events scheduled after those in the queue,
+    // including those still being pushed
+    if (!m_eventsWithContextOverflowing.load(std::memory_order_acquire) ||
+        !m_eventsWithContext.IsEmpty())
+    {
+        return;
+    }
     EventsWithContext eventsWithContext;
     {
         std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        m_eventsWithContextOverflow.swap(eventsWithContext);
+        m_eventsWithContextOverflowing.store(false, std::memory_order_release);
     }
-    while (!eventsWithContext.empty())
+    for (const auto& overflow : eventsWithContext)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
-        Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
-        ev.key.m_uid = m_uid;
-        m_uid++;
-        m_unscheduledEvents++;
-        m_events->Insert(ev);
+        InsertEventWithContext(overflow);
     }
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext(const EventWithContext& event)
+{
+    Scheduler::Event ev;
+    ev.impl = event.event;
+    ev.key.m_ts = m_currentTs + event.timestamp;
+    ev.key.m_context = event.context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
 void
 DefaultSimulatorImpl::Run()
 {
@@ -180,10 +278,19 @@ DefaultSimulatorImpl::Run()
     m_mainThreadId = std::this_thread::get_id();
     ProcessEventsWithContext();
     m_stop = false;
+    m_profiler.SetInterval(m_profileInterval);
+    m_profileCountdown = m_profiler.NextGap();
 
     while (!m_events->IsEmpty() && !m_stop)
     {
-        ProcessOneEvent();
+        if (m_batchEvents)
+        {
+            ProcessEventBatch();
+        }
+        else
+        {
+            ProcessOneEvent();
+        }
     }
 
     // If the simulator stopped naturally by lack of events, make a
@@ -253,10 +360,12 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
+        if (m_eventsWithContextOverflowing.load(std::memory_order_acquire) ||
+            !m_eventsWithContext.Push(ev))
         {
             std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
+            m_eventsWithContextOverflow.push_back(ev);
+            m_eventsWithContextOverflowing.store(true, std::memory_order_release);
         }
     }
 }
@@ -327,7 +436,25 @@ DefaultSimulatorImpl::Remove(const EventId& id)
     event.key.m_ts = id.GetTs();
     event.key.m_context = id.GetContext();
     event.key.m_uid = id.GetUid();
-    m_events->Remove(event);
+    // the event may be waiting in the batch being processed
+    auto batched = m_batch.end();
+    if (event.key.m_ts == m_currentTs)
+    {
+        batched = std::lower_bound(m_batch.begin() + m_batchNext,
+                                   m_batch.end(),
+                                   event,
+                                   [](const Scheduler::Event& a, const Scheduler::Event& b) {
+                                       return a.key.m_uid < b.key.m_uid;
+                                   });
+    }
+    if (batched != m_batch.end() && batched->key.m_uid == event.key.m_uid)
+    {
+        m_batch.erase(batched);
+    }
+    else
+    {
+        m_events->Remove(event);
+    }
     event.impl->Cancel();
     // whenever we remove an event from the event list, we have to unref it.
     event.impl->Unref();
@@ -9,11 +9,17 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
+#include "mpsc-queue.h"
+#include "scheduler.h"
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 /**
  * @file
@@ -24,9 +30,6 @@
 namespace ns3
 {
 
-// Forward
-class Scheduler;
-
 /**
  * @ingroup simulator
  *
@@ -72,6 +75,17 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Process the next event. */
     void ProcessOneEvent();
+    /**
+     * Process the events with the earliest time stamp, removed from the
+     * scheduler in one call, in the order of their uids.
+     */
+    void ProcessEventBatch();
+    /**
+     * Run an event removed from the scheduler.
+     *
+     * @param [in] next The event.
+     */
+    void InvokeEvent(const Scheduler::Event& next);
     /** Move events from a different context into the main event queue. */
     void ProcessEventsWithContext();
 
@@ -86,16 +100,28 @@ class DefaultSimulatorImpl : public SimulatorImpl
         EventImpl* event;
     };
 
-    /** Container type for the events from a different context. */
+    /**
+     * Insert an event from a different thread into the main event queue.
+     *
+     * @param [in] event The event.
+     */
+    void InsertEventWithContext(const EventWithContext& event);
+
+    /** Capacity of the queue of events from a different thread. */
+    static constexpr uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 4096;
+    /** The events from a different thread, in the order they were scheduled. */
+    MpscQueue<EventWithContext> m_eventsWithContext;
+    /** Container type for the events which did not fit in the queue. */
     typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
+    /** The events from a different thread which did not fit in the queue. */
+    EventsWithContext m_eventsWithContextOverflow;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * Flag \c true while there are events in the overflow list.  Later
+     * events go to the overflow list too, so that events scheduled by
+     * one thread stay in order.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
+    std::atomic<bool> m_eventsWithContextOverflowing;
+    /** Mutex to control access to the overflow list. */
     std::mutex m_eventsWithContextMutex;
 
     /** Container type for the events to run at Simulator::Destroy() */
@@ -106,6 +132,12 @@ class DefaultSimulatorImpl : public SimulatorImpl
     bool m_stop;
     /** The event priority queue. */
     Ptr<Scheduler> m_events;
+    /** Flag to process the events with the same time stamp as a batch. */
+    bool m_batchEvents;
+    /** The batch of events being processed, in increasing uid order. */
+    std::vector<Scheduler::Event> m_batch;
+    /** Index in m_batch of the next event to process. */
+    std::size_t m_batchNext;
 
     /** Next event unique id. */
     uint32_t m_uid;
@@ -125,6 +157,17 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** The event profiler. */
+    EventProfiler m_profiler;
+    /** Number of events until the next one timed by the profiler. */
+    uint64_t m_profileCountdown;
+    /** Average number of events between two profiler samples, zero to disable. */
+    uint32_t m_profileInterval;
+    /** Number of lines in each table of the profile report. */
+    uint32_t m_profileTopN;
+    /** File name for the profile in the flame graph format, if any. */
+    std::string m_profileFile;
 };
 
 } // namespace ns3
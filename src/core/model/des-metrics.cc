@@ -14,9 +14,12 @@
 
 #include "des-metrics.h"
 
+#include "global-value.h"
 #include "simulator.h"
+#include "string.h"
 #include "system-path.h"
 
+#include <cstring>
 #include <ctime> // time_t, time()
 #include <sstream>
 #include <string>
@@ -24,9 +27,48 @@
 namespace ns3
 {
 
+namespace
+{
+
+/**
+ * @ingroup simulator
+ * The format of the DesMetrics trace file.
+ */
+GlobalValue g_desMetricsFormat("DesMetricsFormat",
+                               "The format of the DES Metrics trace file: json or binary",
+                               StringValue("json"),
+                               MakeStringChecker());
+
+/** The start of a binary trace file. */
+constexpr char BINARY_MAGIC[] = {'N', 'S', '3', 'D', 'E', 'S', 'M', '1'};
+
+/** Number of records in a thread buffer. */
+constexpr std::size_t RECORDS_PER_BUFFER = 4096;
+
+/** The end of the JSON trace file, after the last event. */
+constexpr char JSON_TRAILER[] = "\n ]\n}\n";
+
+/**
+ * Write an event record in the JSON format.
+ *
+ * @param [in,out] os The output stream.
+ * @param [in] record The record.
+ */
+void
+WriteJsonRecord(std::ostream& os, const DesMetrics::Record& record)
+{
+    os << "  [\"" << record.send << "\",\"" << record.sendTime << "\",\"" << record.recv << "\",\""
+       << record.time << "\"]";
+}
+
+} // unnamed namespace
+
 /* static */
 std::string DesMetrics::m_outputDir; // = "";
 
+/* static */
+thread_local DesMetrics::ThreadBuffer DesMetrics::g_buffer;
+
 void
 DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = "" */)
 {
@@ -44,7 +86,10 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
         const std::string& arg0 = args[0];
         model_name = SystemPath::Split(arg0).back();
     }
-    std::string jsonFile = model_name + ".json";
+    StringValue format;
+    g_desMetricsFormat.GetValue(format);
+    m_binary = format.Get() == "binary";
+    std::string jsonFile = model_name + (m_binary ? ".bin" : ".json");
     if (!outDir.empty())
     {
         DesMetrics::m_outputDir = outDir;
@@ -59,31 +104,49 @@ DesMetrics::Initialize(std::vector<std::string> args, std::string outDir /* = ""
     const char* date = ctime(&current_time);
     std::string capture_date(date, 24); // discard trailing newline from ctime
 
-    m_os.open(jsonFile);
-    m_os << "{" << std::endl;
-    m_os << " \"simulator_name\" : \"ns-3\"," << std::endl;
-    m_os << " \"model_name\" : \"" << model_name << "\"," << std::endl;
-    m_os << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
-    m_os << " \"command_line_arguments\" : \"";
+    std::ostringstream header;
+    header << "{" << std::endl;
+    header << " \"simulator_name\" : \"ns-3\"," << std::endl;
+    header << " \"model_name\" : \"" << model_name << "\"," << std::endl;
+    header << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
+    header << " \"command_line_arguments\" : \"";
     if (args.empty())
     {
         for (std::size_t i = 0; i < args.size(); ++i)
         {
             if (i > 0)
             {
-                m_os << " ";
+                header << " ";
             }
-            m_os << args[i];
+            header << args[i];
         }
     }
     else
     {
-        m_os << "[argv empty or not available]";
+        header << "[argv empty or not available]";
     }
-    m_os << "\"," << std::endl;
-    m_os << " \"events\" : [" << std::endl;
+    header << "\"," << std::endl;
+    header << " \"events\" : [" << std::endl;
 
     m_separator = ' ';
+    if (!m_binary)
+    {
+        m_os.open(jsonFile);
+        m_os << header.str();
+        return;
+    }
+
+    m_os.open(jsonFile, std::ios::binary);
+    uint32_t sizes[] = {static_cast<uint32_t>(header.str().size()), sizeof(Record)};
+    m_os.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    m_os.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    m_os << header.str();
+
+    // a new session, so that the thread buffers left from the previous
+    // file register again
+    m_session++;
+    m_closing = false;
+    m_writer = std::thread(&DesMetrics::WriteBuffers, this);
 }
 
 void
@@ -101,19 +164,24 @@ DesMetrics::TraceWithContext(uint32_t context, const Time& now, const Time& dela
         Initialize(args);
     }
 
-    std::ostringstream ss;
-    if (m_separator == ',')
-    {
-        ss << m_separator << std::endl;
-    }
-
     uint32_t sendCtx = Simulator::GetContext();
     // Force to signed so we can show NoContext as '-1'
     int32_t send = (sendCtx != Simulator::NO_CONTEXT) ? (int32_t)sendCtx : -1;
     int32_t recv = (context != Simulator::NO_CONTEXT) ? (int32_t)context : -1;
+    Record record{send, recv, now.GetTimeStep(), (now + delay).GetTimeStep()};
 
-    ss << "  [\"" << send << "\",\"" << now.GetTimeStep() << "\",\"" << recv << "\",\""
-       << (now + delay).GetTimeStep() << "\"]";
+    if (m_binary)
+    {
+        AddRecord(record);
+        return;
+    }
+
+    std::ostringstream ss;
+    if (m_separator == ',')
+    {
+        ss << m_separator << std::endl;
+    }
+    WriteJsonRecord(ss, record);
 
     {
         std::unique_lock lock{m_mutex};
@@ -131,6 +199,30 @@ DesMetrics::~DesMetrics()
 void
 DesMetrics::Close()
 {
+    if (m_binary && m_writer.joinable())
+    {
+        {
+            std::unique_lock lock{m_bufferMutex};
+            for (auto buffer : m_threadBuffers)
+            {
+                if (!buffer->records.empty())
+                {
+                    m_full.push_back(std::move(buffer->records));
+                    buffer->records = {};
+                }
+                buffer->session = 0;
+            }
+            m_threadBuffers.clear();
+            m_closing = true;
+        }
+        m_bufferReady.notify_one();
+        m_writer.join();
+        m_free.clear();
+        m_os.close();
+        m_initialized = false;
+        return;
+    }
+
     m_os << std::endl; // Finish the last event line
 
     m_os << " ]" << std::endl;
@@ -140,4 +232,125 @@ DesMetrics::Close()
     m_initialized = false;
 }
 
+void
+DesMetrics::AddRecord(const Record& record)
+{
+    ThreadBuffer& buffer = g_buffer;
+    if (buffer.session != m_session)
+    {
+        std::unique_lock lock{m_bufferMutex};
+        buffer.session = m_session;
+        buffer.records.clear();
+        m_threadBuffers.push_back(&buffer);
+    }
+    buffer.records.push_back(record);
+    if (buffer.records.size() >= RECORDS_PER_BUFFER)
+    {
+        Submit(buffer);
+    }
+}
+
+void
+DesMetrics::Submit(ThreadBuffer& buffer)
+{
+    {
+        std::unique_lock lock{m_bufferMutex};
+        m_full.push_back(std::move(buffer.records));
+        buffer.records = {};
+        if (!m_free.empty())
+        {
+            buffer.records = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_bufferReady.notify_one();
+    buffer.records.reserve(RECORDS_PER_BUFFER);
+}
+
+void
+DesMetrics::WriteBuffers()
+{
+    std::unique_lock lock{m_bufferMutex};
+    for (;;)
+    {
+        m_bufferReady.wait(lock, [this]() { return !m_full.empty() || m_closing; });
+        if (m_full.empty())
+        {
+            break;
+        }
+        std::vector<Record> records = std::move(m_full.front());
+        m_full.pop_front();
+        lock.unlock();
+        m_os.write(reinterpret_cast<const char*>(records.data()),
+                   records.size() * sizeof(Record));
+        records.clear();
+        lock.lock();
+        m_free.push_back(std::move(records));
+    }
+}
+
+DesMetrics::ThreadBuffer::~ThreadBuffer()
+{
+    if (session == 0)
+    {
+        return;
+    }
+    // the thread ends before the trace file is closed
+    DesMetrics* metrics = DesMetrics::Get();
+    {
+        std::unique_lock lock{metrics->m_bufferMutex};
+        metrics->m_threadBuffers.remove(this);
+        if (session != metrics->m_session || records.empty())
+        {
+            return;
+        }
+        metrics->m_full.push_back(std::move(records));
+    }
+    metrics->m_bufferReady.notify_one();
+}
+
+/* static */
+bool
+DesMetrics::ConvertToJson(std::istream& is, std::ostream& os)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    uint32_t sizes[2];
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (!is || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0 || sizes[1] != sizeof(Record))
+    {
+        return false;
+    }
+    std::string header(sizes[0], ' ');
+    is.read(header.data(), header.size());
+    if (!is)
+    {
+        return false;
+    }
+    os << header;
+
+    std::vector<Record> records(RECORDS_PER_BUFFER);
+    bool first = true;
+    while (is)
+    {
+        is.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+        auto bytes = static_cast<std::size_t>(is.gcount());
+        if (bytes % sizeof(Record) != 0)
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < bytes / sizeof(Record); ++i)
+        {
+            if (!first)
+            {
+                os << "," << std::endl;
+            }
+            first = false;
+            WriteJsonRecord(os, records[i]);
+        }
+    }
+    os << JSON_TRAILER;
+    return true;
+}
+
 } // namespace ns3
@@ -18,10 +18,15 @@
 #include "nstime.h"
 #include "singleton.h"
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <iostream>
+#include <list>
 #include <mutex>
 #include <stdint.h> // uint32_t
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace ns3
@@ -80,6 +85,26 @@ namespace ns3
  * @verbatim
    $ ns3 configure ... --enable-des-metrics \endverbatim
  *
+ * <b> Binary trace format </b>
+ *
+ * Writing a JSON record per event under a lock slows the simulation
+ * down, and makes large files.  Setting the \c DesMetricsFormat global
+ * value to \c binary, for instance with
+ * @verbatim
+   $ ./ns3 run "ipv4-raw --DesMetricsFormat=binary" \endverbatim
+ * writes fixed-width records instead, to a file with the \c .bin
+ * extension.  Each thread fills its own buffer of records, which a
+ * background thread writes to the file once full.
+ *
+ * The file starts with the eight bytes \c NS3DESM1, the length of the
+ * JSON header and the size of a record, as two \c uint32_t, and the
+ * JSON header itself.  Then come the records: a DesMetrics::Record per
+ * event, in host byte order.  Records of different threads are
+ * interleaved by buffer.  The \c des-metrics-to-json program converts
+ * the trace to the JSON format above, for the existing analysis tools:
+ * @verbatim
+   $ ./build/utils/ns3-dev-des-metrics-to-json-debug ipv4-raw.bin ipv4-raw.json \endverbatim
+ *
  * <b> Working with DES Metrics </b>
  *
  * Some useful shell pipelines:
@@ -131,10 +156,61 @@ class DesMetrics : public Singleton<DesMetrics>
      */
     ~DesMetrics() override;
 
-  private:
-    /** Close the output file. */
+    /**
+     * Close the output file, writing the records still buffered.  The
+     * next trace opens a new file.
+     *
+     * The threads tracing events must be done when this is called.
+     */
     void Close();
 
+    /** An event record of the binary trace format. */
+    struct Record
+    {
+        int32_t send;     //!< The source context, -1 for none.
+        int32_t recv;     //!< The destination context, -1 for none.
+        int64_t sendTime; //!< The time the event was scheduled, in time steps.
+        int64_t time;     //!< The time the event will execute, in time steps.
+    };
+
+    /**
+     * Convert a binary trace to the JSON format.
+     *
+     * @param [in] is The binary trace.
+     * @param [out] os The stream for the JSON trace.
+     * @returns \c false if \p is is not a binary trace, or is truncated.
+     */
+    static bool ConvertToJson(std::istream& is, std::ostream& os);
+
+  private:
+    /** The records buffered by one thread. */
+    struct ThreadBuffer
+    {
+        /** Destructor, handing the records over to the writer. */
+        ~ThreadBuffer();
+
+        std::vector<Record> records; //!< The records not written yet.
+        uint64_t session{0};         //!< The binary trace they belong to.
+    };
+
+    /**
+     * Add a record to the buffer of the current thread.
+     *
+     * @param [in] record The record.
+     */
+    void AddRecord(const Record& record);
+    /**
+     * Hand the records of a buffer over to the writer thread.
+     *
+     * @param [in,out] buffer The buffer, left empty.
+     */
+    void Submit(ThreadBuffer& buffer);
+    /** Body of the writer thread: write the full buffers to the file. */
+    void WriteBuffers();
+
+    /** The records of the current thread. */
+    static thread_local ThreadBuffer g_buffer;
+
     /**
      * Cache the last-used output directory.
      *
@@ -150,6 +226,19 @@ class DesMetrics : public Singleton<DesMetrics>
     /** Mutex to control access to the output file. */
     std::mutex m_mutex;
 
+    bool m_binary{false};  //!< Is the trace file in the binary format.
+    uint64_t m_session{0}; //!< Number of binary trace files opened.
+    /** The thread buffers holding records of the current trace. */
+    std::list<ThreadBuffer*> m_threadBuffers;
+    std::deque<std::vector<Record>> m_full;  //!< The buffers to write.
+    std::vector<std::vector<Record>> m_free; //!< The buffers written, for reuse.
+    bool m_closing{false};                   //!< Should the writer thread end.
+    std::thread m_writer;                    //!< The writer thread.
+    /** Mutex to control access to the buffers. */
+    std::mutex m_bufferMutex;
+    /** Signals full buffers, or closing, to the writer thread. */
+    std::condition_variable m_bufferReady;
+
 }; // class DesMetrics
 
 } // namespace ns3
@@ -10,6 +10,12 @@
 
 #include "log.h"
 
+#include <new>
+
+#ifdef ENABLE_EVENT_POOL
+#include <mutex>
+#endif
+
 /**
  * @file
  * @ingroup events
@@ -21,6 +27,212 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+#ifdef ENABLE_EVENT_POOL
+/**
+ * @ingroup events
+ * Unnamed namespace for the event pool.
+ */
+namespace
+{
+
+/** Size class granularity, and block alignment, in bytes. */
+constexpr std::size_t POOL_GRANULE = 16;
+/** Number of size classes; larger events use the global heap. */
+constexpr std::size_t POOL_CLASSES = 16;
+/** Number of blocks moved at once between a thread cache and the shared pool. */
+constexpr std::size_t POOL_BATCH = 64;
+/** Free blocks per size class above which a thread cache gives half of them back. */
+constexpr std::size_t POOL_CACHE_MAX = 8 * POOL_BATCH;
+
+static_assert(POOL_GRANULE % alignof(std::max_align_t) == 0,
+              "pool blocks must be aligned for any fundamental type");
+
+/** A free block, linked into a free list. */
+struct FreeBlock
+{
+    FreeBlock* next; /**< Next free block. */
+};
+
+/** A free list of blocks of one size class. */
+struct FreeList
+{
+    FreeBlock* head{nullptr}; /**< First free block. */
+    std::size_t count{0};     /**< Number of free blocks. */
+
+    /**
+     * Move up to \p n blocks to another list.
+     * @param [in] to The destination list.
+     * @param [in] n The number of blocks to move.
+     */
+    void MoveTo(FreeList& to, std::size_t n)
+    {
+        for (; n > 0 && head; --n)
+        {
+            FreeBlock* block = head;
+            head = block->next;
+            --count;
+            block->next = to.head;
+            to.head = block;
+            ++to.count;
+        }
+    }
+};
+
+/**
+ * The free blocks shared by all threads.  The memory of the pool is
+ * never returned to the system.
+ */
+class SharedPool
+{
+  public:
+    /**
+     * Fill a thread cache free list with a batch of blocks.
+     * @param [in] sizeClass The size class.
+     * @param [in,out] list The thread cache list.
+     */
+    void Refill(std::size_t sizeClass, FreeList& list)
+    {
+        std::lock_guard lock(m_mutex);
+        FreeList& shared = m_lists[sizeClass];
+        if (shared.count == 0)
+        {
+            std::size_t blockSize = (sizeClass + 1) * POOL_GRANULE;
+            auto chunk = static_cast<char*>(::operator new(blockSize * POOL_BATCH));
+            for (std::size_t i = 0; i < POOL_BATCH; ++i)
+            {
+                auto block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+                block->next = shared.head;
+                shared.head = block;
+            }
+            shared.count = POOL_BATCH;
+        }
+        shared.MoveTo(list, POOL_BATCH);
+    }
+
+    /**
+     * Take back blocks from a thread cache free list.
+     * @param [in] sizeClass The size class.
+     * @param [in,out] list The thread cache list.
+     * @param [in] n The number of blocks to take.
+     */
+    void Release(std::size_t sizeClass, FreeList& list, std::size_t n)
+    {
+        std::lock_guard lock(m_mutex);
+        list.MoveTo(m_lists[sizeClass], n);
+    }
+
+  private:
+    std::mutex m_mutex;             /**< Protects the lists. */
+    FreeList m_lists[POOL_CLASSES]; /**< Free blocks by size class. */
+};
+
+/**
+ * @returns The shared pool.  It is never destroyed, so events released
+ * during static destruction still find it.
+ */
+SharedPool&
+GetSharedPool()
+{
+    static auto pool = new SharedPool;
+    return *pool;
+}
+
+/** Set once the thread cache of the current thread has been destroyed. */
+thread_local bool t_cacheDestroyed = false;
+
+/** The free blocks of one thread. */
+struct ThreadCache
+{
+    FreeList lists[POOL_CLASSES]; /**< Free blocks by size class. */
+
+    /** Give all the blocks back to the shared pool at thread exit. */
+    ~ThreadCache()
+    {
+        t_cacheDestroyed = true;
+        for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+        {
+            GetSharedPool().Release(i, lists[i], lists[i].count);
+        }
+    }
+};
+
+/** The cache of the current thread. */
+thread_local ThreadCache t_cache;
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / POOL_GRANULE;
+    if (sizeClass >= POOL_CLASSES || t_cacheDestroyed)
+    {
+        return ::operator new(size);
+    }
+    FreeList& list = t_cache.lists[sizeClass];
+    if (list.count == 0)
+    {
+        GetSharedPool().Refill(sizeClass, list);
+    }
+    FreeBlock* block = list.head;
+    list.head = block->next;
+    --list.count;
+    return block;
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / POOL_GRANULE;
+    if (sizeClass >= POOL_CLASSES)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<FreeBlock*>(p);
+    if (t_cacheDestroyed)
+    {
+        FreeList list{block, 1};
+        GetSharedPool().Release(sizeClass, list, 1);
+        return;
+    }
+    FreeList& list = t_cache.lists[sizeClass];
+    block->next = list.head;
+    list.head = block;
+    if (++list.count > POOL_CACHE_MAX)
+    {
+        GetSharedPool().Release(sizeClass, list, POOL_CACHE_MAX / 2);
+    }
+}
+
+bool
+EventImpl::IsPoolEnabled()
+{
+    return true;
+}
+
+#else /* ENABLE_EVENT_POOL */
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */)
+{
+    ::operator delete(p);
+}
+
+bool
+EventImpl::IsPoolEnabled()
+{
+    return false;
+}
+
+#endif /* ENABLE_EVENT_POOL */
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
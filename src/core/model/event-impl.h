@@ -10,6 +10,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -30,6 +31,14 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * When ns-3 is configured with `--enable-event-pool`
+ * (`-DNS3_EVENT_POOL=ON`), EventImpl and its subclasses are allocated
+ * from per-size free lists instead of the global heap.  Each thread
+ * keeps a small cache of free blocks, refilled from and flushed to a
+ * shared pool, so events can be created and released on any thread.
+ * Blocks are aligned for any type of fundamental alignment; events
+ * larger than the largest size class use the global heap.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -56,6 +65,25 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the storage of an event.
+     *
+     * @param [in] size The size of the event object, in bytes.
+     * @returns The storage.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the storage of an event.
+     *
+     * @param [in] p The storage.
+     * @param [in] size The size of the event object, in bytes.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * @returns \c true if events are allocated from the event pool.
+     */
+    static bool IsPoolEnabled();
+
   protected:
     /**
      * Implementation for Invoke().
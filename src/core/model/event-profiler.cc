@@ -0,0 +1,236 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "event-profiler.h"
+
+#include "demangle.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+EventProfiler::EventProfiler()
+    : m_interval(0),
+      m_count(0),
+      m_ns(0),
+      m_state(0x9e3779b97f4a7c15ULL)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EventProfiler::SetInterval(uint32_t interval)
+{
+    NS_LOG_FUNCTION(this << interval);
+    m_interval = interval;
+}
+
+uint32_t
+EventProfiler::GetInterval() const
+{
+    return m_interval;
+}
+
+uint64_t
+EventProfiler::NextGap()
+{
+    if (m_interval == 0)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    // xorshift64
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 7;
+    m_state ^= m_state << 17;
+    return 1 + m_state % (2 * static_cast<uint64_t>(m_interval) - 1);
+}
+
+bool
+EventProfiler::Key::operator==(const Key& other) const
+{
+    return *type == *other.type && context == other.context;
+}
+
+std::size_t
+EventProfiler::KeyHash::operator()(const Key& key) const
+{
+    return key.type->hash_code() ^ (static_cast<std::size_t>(key.context) * 0x9e3779b97f4a7c15ULL);
+}
+
+void
+EventProfiler::Record(const std::type_info& type, uint32_t context, uint64_t ns)
+{
+    Samples& samples = m_samples[{&type, context}];
+    samples.count++;
+    samples.ns += ns;
+    m_count++;
+    m_ns += ns;
+}
+
+uint64_t
+EventProfiler::GetSampleCount() const
+{
+    return m_count;
+}
+
+void
+EventProfiler::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_samples.clear();
+    m_count = 0;
+    m_ns = 0;
+}
+
+std::string
+EventProfiler::GetEventName(const std::type_info& type)
+{
+    std::string name = Demangle(type.name());
+
+    // The local classes of MakeEvent() are named after the function
+    // template, whose first parameter is the function called:
+    // ns3::MakeEvent<...>(void (ns3::Node::*)(), ns3::Node*)::EventMemberImpl
+    std::string prefix = "ns3::MakeEvent<";
+    if (name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return name;
+    }
+    std::size_t i = prefix.size();
+    for (int depth = 1; i < name.size() && depth > 0; ++i)
+    {
+        depth += name[i] == '<' ? 1 : (name[i] == '>' ? -1 : 0);
+    }
+    if (i >= name.size() || name[i] != '(')
+    {
+        return name;
+    }
+    std::size_t begin = ++i;
+    for (int depth = 0; i < name.size(); ++i)
+    {
+        char c = name[i];
+        if ((c == ',' || c == ')') && depth == 0)
+        {
+            break;
+        }
+        depth += (c == '(' || c == '<' || c == '{') ? 1 : 0;
+        depth -= (c == ')' || c == '>' || c == '}') ? 1 : 0;
+    }
+    return name.substr(begin, i - begin);
+}
+
+namespace
+{
+
+/**
+ * @ingroup simulator
+ * Print the table of the largest totals for one of the report tables.
+ *
+ * @param [in,out] os The output stream.
+ * @param [in] title The title of the first column.
+ * @param [in] totals The estimated events and time (ns), by name.
+ * @param [in] totalNs The total estimated time of all the events (ns).
+ * @param [in] topN The number of lines.
+ */
+void
+PrintTable(std::ostream& os,
+           const std::string& title,
+           const std::map<std::string, std::pair<uint64_t, uint64_t>>& totals,
+           uint64_t totalNs,
+           uint32_t topN)
+{
+    std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> rows(totals.begin(),
+                                                                             totals.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second.second > b.second.second;
+    });
+    rows.resize(std::min<std::size_t>(rows.size(), topN));
+
+    os << std::right << std::setw(8) << "Time %" << std::setw(14) << "Time (s)" << std::setw(14)
+       << "Events"
+       << "  " << title << std::endl;
+    for (const auto& [name, total] : rows)
+    {
+        os << std::right << std::fixed << std::setprecision(2) << std::setw(8)
+           << (totalNs > 0 ? 100.0 * total.second / totalNs : 0) << std::setprecision(6)
+           << std::setw(14) << total.second / 1e9 << std::setw(14) << total.first << "  "
+           << name << std::endl;
+    }
+    os << std::defaultfloat;
+}
+
+/**
+ * @ingroup simulator
+ * Get the name of a context in the report.
+ *
+ * @param [in] context The context.
+ * @returns The name.
+ */
+std::string
+ContextName(uint32_t context)
+{
+    return context == Simulator::NO_CONTEXT ? "no context" : "node " + std::to_string(context);
+}
+
+} // unnamed namespace
+
+void
+EventProfiler::Report(std::ostream& os, uint32_t topN) const
+{
+    NS_LOG_FUNCTION(this << topN);
+    std::map<std::string, std::pair<uint64_t, uint64_t>> byEvent;
+    std::map<std::string, std::pair<uint64_t, uint64_t>> byContext;
+    for (const auto& [key, samples] : m_samples)
+    {
+        uint64_t count = samples.count * m_interval;
+        uint64_t ns = samples.ns * m_interval;
+        auto& event = byEvent[GetEventName(*key.type)];
+        event.first += count;
+        event.second += ns;
+        auto& context = byContext[ContextName(key.context)];
+        context.first += count;
+        context.second += ns;
+    }
+
+    os << "Event profile: " << m_count << " events sampled, 1 in " << m_interval
+       << ", about " << m_count * m_interval << " events in " << m_ns * m_interval / 1e9
+       << " s" << std::endl;
+    PrintTable(os, "Event", byEvent, m_ns * m_interval, topN);
+    PrintTable(os, "Context", byContext, m_ns * m_interval, topN);
+}
+
+void
+EventProfiler::WriteFlameGraph(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this);
+    // sorted, so that the output is stable
+    std::map<std::string, uint64_t> stacks;
+    for (const auto& [key, samples] : m_samples)
+    {
+        std::string name = GetEventName(*key.type);
+        // ';' separates the frames
+        std::replace(name.begin(), name.end(), ';', ',');
+        stacks[name + ";" + ContextName(key.context)] += samples.ns * m_interval / 1000;
+    }
+    for (const auto& [stack, us] : stacks)
+    {
+        os << stack << " " << us << std::endl;
+    }
+}
+
+} // namespace ns3
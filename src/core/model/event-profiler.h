@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup simulator
+ * @brief A sampling profiler of the wall clock time spent in the events.
+ *
+ * The simulator implementation times one event in every \c interval, on
+ * average, and records its time with Record().  The samples are
+ * attributed to the type of the EventImpl, which for the events made by
+ * MakeEvent() names the function or member function called, and to the
+ * event context, usually the node id.  Counts and times are extrapolated
+ * to all the events from the sampling interval.
+ *
+ * The gap between two samples is drawn at random, with a private
+ * generator which leaves the simulation random variables alone, so that
+ * periodic events are not systematically missed or hit.
+ *
+ * DefaultSimulatorImpl uses it when its \c ProfileInterval attribute is
+ * not zero.
+ */
+class EventProfiler
+{
+  public:
+    /** Constructor. */
+    EventProfiler();
+
+    /**
+     * Set the average number of events between two samples.
+     *
+     * @param [in] interval The sampling interval; zero disables sampling.
+     */
+    void SetInterval(uint32_t interval);
+    /**
+     * @returns The sampling interval, zero if disabled.
+     */
+    uint32_t GetInterval() const;
+    /**
+     * Draw the number of events until the next sample.
+     *
+     * @returns The gap, uniform between 1 and twice the interval minus one,
+     *          or the largest value if sampling is disabled.
+     */
+    uint64_t NextGap();
+
+    /**
+     * Record the time of a sampled event.
+     *
+     * @param [in] type The dynamic type of the EventImpl.
+     * @param [in] context The event context.
+     * @param [in] ns The wall clock time of the event (ns).
+     */
+    void Record(const std::type_info& type, uint32_t context, uint64_t ns);
+    /**
+     * @returns The number of events sampled.
+     */
+    uint64_t GetSampleCount() const;
+    /** Forget the samples recorded so far. */
+    void Clear();
+
+    /**
+     * Print the event types and the contexts taking the most time.
+     *
+     * @param [in,out] os The output stream.
+     * @param [in] topN The number of lines in each table.
+     */
+    void Report(std::ostream& os, uint32_t topN) const;
+    /**
+     * Write the samples in the folded stack format of the flame graph
+     * tools: one \c "event;context time" line per event type and context,
+     * with the estimated time in microseconds.
+     *
+     * @param [in,out] os The output stream.
+     */
+    void WriteFlameGraph(std::ostream& os) const;
+
+    /**
+     * Get a readable name for an event type.  For the events made by
+     * MakeEvent(), this is the type of the function called, such as
+     * <tt>void (ns3::Node::*)()</tt>, or the lambda.
+     *
+     * @param [in] type The dynamic type of the EventImpl.
+     * @returns The name.
+     */
+    static std::string GetEventName(const std::type_info& type);
+
+  private:
+    /** The samples of an event type in a context. */
+    struct Key
+    {
+        const std::type_info* type; //!< The EventImpl type.
+        uint32_t context;           //!< The event context.
+
+        /**
+         * Equality operator.
+         * @param [in] other The other key.
+         * @returns \c true if both keys are equal.
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /** Hash of a Key. */
+    struct KeyHash
+    {
+        /**
+         * Functor returning the hash of a key.
+         * @param [in] key The key.
+         * @returns The hash.
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /** What the samples of a Key add up to. */
+    struct Samples
+    {
+        uint64_t count; //!< Number of samples.
+        uint64_t ns;    //!< Total time (ns).
+    };
+
+    /** The samples, by event type and context. */
+    std::unordered_map<Key, Samples, KeyHash> m_samples;
+    /** The sampling interval. */
+    uint32_t m_interval;
+    /** Number of events sampled. */
+    uint64_t m_count;
+    /** Total time of the events sampled (ns). */
+    uint64_t m_ns;
+    /** State of the xorshift generator drawing the gaps. */
+    uint64_t m_state;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -11,6 +11,7 @@
 #include "environment-variable.h"
 #include "fatal-error.h"
 #include "log.h"
+#include "startup-profile.h"
 #include "string.h"
 #include "uinteger.h"
 
@@ -37,6 +38,7 @@ GlobalValue::GlobalValue(std::string name,
       m_currentValue(nullptr),
       m_checker(checker)
 {
+    StartupProfile::Timer timer(StartupProfile::GLOBAL_VALUE);
     NS_LOG_FUNCTION(name << help << &initialValue << checker);
     if (!m_checker)
     {
@@ -0,0 +1,348 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * @file
+ * @ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "Bucket size above which a bucket is spread over a new rung "
+                          "instead of being sorted",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "Maximum number of rungs of the ladder",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_nRungs(0),
+      m_qSize(0),
+      m_threshold(50),
+      m_maxRungs(8)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::Boundary(const Rung& rung)
+{
+    if (rung.current >= rung.nBuckets)
+    {
+        return rung.end;
+    }
+    return rung.start + rung.current * rung.width;
+}
+
+uint32_t
+LadderScheduler::BucketIndex(const Rung& rung, uint64_t ts)
+{
+    uint64_t index = (ts - rung.start) / rung.width;
+    return static_cast<uint32_t>(std::min<uint64_t>(index, rung.nBuckets - 1));
+}
+
+bool
+LadderScheduler::RemoveFromBucket(Bucket& bucket, const Event& ev)
+{
+    for (auto i = bucket.begin(); i != bucket.end(); ++i)
+    {
+        if (i->key.m_uid == ev.key.m_uid)
+        {
+            NS_ASSERT(ev.impl == i->impl);
+            *i = bucket.back();
+            bucket.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    if (m_bottom.empty() || m_bottom.back().key < ev.key)
+    {
+        m_bottom.push_back(ev);
+        return;
+    }
+    auto i = std::upper_bound(m_bottom.begin(),
+                              m_bottom.end(),
+                              ev.key,
+                              [](const EventKey& key, const Event& e) { return key < e.key; });
+    m_bottom.insert(i, ev);
+
+    uint64_t minTs = m_bottom.front().key.m_ts;
+    uint64_t maxTs = m_bottom.back().key.m_ts;
+    if (m_bottom.size() > m_threshold && minTs != maxTs && m_nRungs < m_maxRungs)
+    {
+        // keep sorted insertions cheap: spread the bottom over a new last
+        // rung, which Refill() will consume right away.
+        uint64_t end = m_nRungs > 0 ? Boundary(m_rungs[m_nRungs - 1]) : m_topStart;
+        Bucket events(m_bottom.begin(), m_bottom.end());
+        m_bottom.clear();
+        SpawnRung(events, minTs, maxTs, end);
+    }
+}
+
+void
+LadderScheduler::DoInsert(const Event& ev)
+{
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        return;
+    }
+    for (uint32_t r = 0; r < m_nRungs; r++)
+    {
+        Rung& rung = m_rungs[r];
+        if (ts >= Boundary(rung))
+        {
+            NS_LOG_LOGIC("insert in rung=" << r << ", bucket=" << BucketIndex(rung, ts));
+            rung.buckets[BucketIndex(rung, ts)].push_back(ev);
+            return;
+        }
+    }
+    InsertBottom(ev);
+}
+
+void
+LadderScheduler::SpawnRung(Bucket& bucket, uint64_t minTs, uint64_t maxTs, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << bucket.size() << minTs << maxTs << end);
+
+    // about one event per bucket if the time stamps are evenly spread
+    uint64_t width = (maxTs - minTs) / bucket.size() + 1;
+    auto nBuckets = static_cast<uint32_t>((maxTs - minTs) / width + 1);
+
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+    rung.start = minTs;
+    rung.width = width;
+    rung.end = end;
+    rung.current = 0;
+    rung.nBuckets = nBuckets;
+    if (rung.buckets.size() < nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    for (const auto& ev : bucket)
+    {
+        rung.buckets[BucketIndex(rung, ev.key.m_ts)].push_back(ev);
+    }
+    bucket.clear();
+}
+
+void
+LadderScheduler::TopToLadder()
+{
+    NS_LOG_FUNCTION(this << m_top.size());
+    NS_ASSERT(!m_top.empty());
+
+    uint64_t minTs = m_top.front().key.m_ts;
+    uint64_t maxTs = minTs;
+    for (const auto& ev : m_top)
+    {
+        minTs = std::min(minTs, ev.key.m_ts);
+        maxTs = std::max(maxTs, ev.key.m_ts);
+    }
+    m_topStart = maxTs + 1;
+
+    if (m_top.size() <= m_threshold || minTs == maxTs)
+    {
+        std::sort(m_top.begin(), m_top.end());
+        m_bottom.assign(m_top.begin(), m_top.end());
+        m_top.clear();
+        return;
+    }
+    SpawnRung(m_top, minTs, maxTs, m_topStart);
+}
+
+void
+LadderScheduler::Refill()
+{
+    Bucket events;
+    while (m_bottom.empty() && m_qSize > 0)
+    {
+        if (m_nRungs == 0)
+        {
+            TopToLadder();
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        if (rung.current == rung.nBuckets)
+        {
+            NS_LOG_LOGIC("rung " << m_nRungs - 1 << " exhausted");
+            m_nRungs--;
+            continue;
+        }
+
+        // take the bucket out, a new rung may reallocate m_rungs
+        uint32_t r = m_nRungs - 1;
+        uint32_t k = rung.current;
+        uint64_t end = (k == rung.nBuckets - 1) ? rung.end : rung.start + (k + 1) * rung.width;
+        events.swap(rung.buckets[k]);
+        rung.current++;
+
+        uint64_t minTs = events.front().key.m_ts;
+        uint64_t maxTs = minTs;
+        for (const auto& ev : events)
+        {
+            minTs = std::min(minTs, ev.key.m_ts);
+            maxTs = std::max(maxTs, ev.key.m_ts);
+        }
+        if (events.size() > m_threshold && minTs != maxTs && m_nRungs < m_maxRungs)
+        {
+            SpawnRung(events, minTs, maxTs, end);
+        }
+        else
+        {
+            std::sort(events.begin(), events.end());
+            m_bottom.assign(events.begin(), events.end());
+            events.clear();
+        }
+        // give the (empty) storage back to the bucket
+        events.swap(m_rungs[r].buckets[k]);
+    }
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    DoInsert(ev);
+    m_qSize++;
+    Refill();
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom.front();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Event ev = m_bottom.front();
+    m_bottom.pop_front();
+    m_qSize--;
+    Refill();
+    return ev;
+}
+
+void
+LadderScheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    // the bottom holds every event earlier than the first rung boundary,
+    // so all those at the time stamp of the first one
+    uint64_t ts = m_bottom.front().key.m_ts;
+    auto end = m_bottom.begin();
+    for (; end != m_bottom.end() && end->key.m_ts == ts; ++end)
+    {
+        events.push_back(*end);
+    }
+    m_qSize -= end - m_bottom.begin();
+    m_bottom.erase(m_bottom.begin(), end);
+    Refill();
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+
+    uint64_t ts = ev.key.m_ts;
+    [[maybe_unused]] bool found = false;
+    if (ts >= m_topStart)
+    {
+        found = RemoveFromBucket(m_top, ev);
+    }
+    else
+    {
+        uint32_t r = 0;
+        while (r < m_nRungs && ts < Boundary(m_rungs[r]))
+        {
+            r++;
+        }
+        if (r < m_nRungs)
+        {
+            found = RemoveFromBucket(m_rungs[r].buckets[BucketIndex(m_rungs[r], ts)], ev);
+        }
+        else
+        {
+            auto i = std::lower_bound(m_bottom.begin(), m_bottom.end(), ev);
+            if (i != m_bottom.end() && i->key.m_uid == ev.key.m_uid)
+            {
+                NS_ASSERT(ev.impl == i->impl);
+                m_bottom.erase(i);
+                found = true;
+            }
+        }
+    }
+    NS_ASSERT_MSG(found, "event to remove not found");
+    m_qSize--;
+    Refill();
+}
+
+} // namespace ns3
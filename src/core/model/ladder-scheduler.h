@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup scheduler
+ * @brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *
+ * - **Top**: an unsorted `std::vector` of the events later than every
+ *   event in the other tiers.  Most insertions land here.
+ * - **Ladder**: up to `MaxRungs` rungs of unsorted buckets.  When the
+ *   bottom runs dry the top is spread over the buckets of the first rung;
+ *   a bucket holding more than `Threshold` events is spread over a new,
+ *   finer rung instead of being sorted.
+ * - **Bottom**: a short `std::deque` sorted by EventKey, from which
+ *   events are removed.  When insertions grow it past `Threshold` events
+ *   it is spread over a new last rung.
+ *
+ * Each event is thus moved a bounded number of times before it reaches
+ * the bottom, and only small groups of events are ever sorted.
+ * Unlike the CalendarScheduler, the buckets adapt to the actual spread
+ * of the events, so the queue copes with clustered and bursty time
+ * stamps.  A bucket whose events all share one time stamp cannot be
+ * split, and goes straight to the bottom, where sorting events already
+ * in uid order is linear.
+ *
+ * @par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or to a bucket; rarely sorted into bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | `std::deque::front()`
+ * Remove()     | ~Constant       | Search within bucket or bottom
+ * RemoveNext() | ~Constant       | Bounded number of moves per event
+ *
+ * @par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | One `std::vector` per bucket     | Buckets are kept for reuse
+ * Per Event | 0                                | Events stored in the containers directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+    void RemoveNextBatch(std::vector<Scheduler::Event>& events) override;
+
+  private:
+    /** Ladder bucket type: an unsorted vector of Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** One rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;              /**< Time stamp at the start of the first bucket. */
+        uint64_t width;              /**< Duration of a bucket. */
+        uint64_t end;                /**< Time stamp past the end of the last bucket. */
+        uint32_t current;            /**< First bucket not yet consumed. */
+        uint32_t nBuckets;           /**< Number of buckets in use. */
+        std::vector<Bucket> buckets; /**< The buckets, possibly more than nBuckets. */
+    };
+
+    /**
+     * Insert an event into the tier covering its time stamp.
+     *
+     * @param [in] ev The event.
+     */
+    void DoInsert(const Scheduler::Event& ev);
+    /**
+     * Sorted insertion into the bottom.
+     *
+     * @param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /**
+     * Refill the bottom from the ladder, or the ladder from the top,
+     * if the bottom is empty and there are events left.
+     */
+    void Refill();
+    /** Spread the top over a new first rung. */
+    void TopToLadder();
+    /**
+     * Spread the events of a bucket over a new, finer rung.
+     *
+     * @param [in] bucket The events to spread.
+     * @param [in] minTs The smallest time stamp in \p bucket.
+     * @param [in] maxTs The largest time stamp in \p bucket.
+     * @param [in] end The time stamp past the end of the bucket.
+     */
+    void SpawnRung(Bucket& bucket, uint64_t minTs, uint64_t maxTs, uint64_t end);
+    /**
+     * The time stamp from which events are inserted into a rung, rather
+     * than into a later rung or the bottom.
+     *
+     * @param [in] rung The rung.
+     * @returns The start of the first bucket not yet consumed.
+     */
+    static uint64_t Boundary(const Rung& rung);
+    /**
+     * The bucket of a rung for a time stamp.  Events past the last
+     * bucket, up to the end of the rung, are kept in the last bucket.
+     *
+     * @param [in] rung The rung.
+     * @param [in] ts The time stamp.
+     * @returns The bucket index.
+     */
+    static uint32_t BucketIndex(const Rung& rung, uint64_t ts);
+    /**
+     * Remove an event by uid from an unsorted bucket.
+     *
+     * @param [in] bucket The bucket.
+     * @param [in] ev The event.
+     * @returns \c true if the event was found.
+     */
+    static bool RemoveFromBucket(Bucket& bucket, const Scheduler::Event& ev);
+
+    /** Events later than every event in the ladder and the bottom. */
+    Bucket m_top;
+    /** Time stamp from which events are inserted into the top. */
+    uint64_t m_topStart;
+    /** The rungs, possibly more than m_nRungs, kept for reuse. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** The next events, in increasing EventKey order. */
+    std::deque<Scheduler::Event> m_bottom;
+    /** Number of events in queue. */
+    uint32_t m_qSize;
+    /** Bucket size above which a bucket is spread over a new rung. */
+    uint32_t m_threshold;
+    /** Maximum number of rungs. */
+    uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,664 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "log-binary-sink.h"
+
+#include "environment-variable.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @file
+ * @ingroup logging
+ * ns3::LogBinarySink implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup logging
+ * The layout of the file written by the LogBinarySink.
+ *
+ * The file starts with FILE_MAGIC, followed by the records.  Each record
+ * starts with its size, not counting the size itself, and its kind.
+ *
+ * A KIND_COMPONENT record holds the id and the name of a LogComponent,
+ * and comes before the first message logged by the LogComponent.
+ *
+ * A KIND_LOG or KIND_FUNCTION record holds, in order:
+ * the id of the LogComponent, the level of the message and the prefixes
+ * enabled, whether the time and the context are known, the time step,
+ * the time resolution, the context, the name of the function logging,
+ * and the arguments, each with its LogBinarySink::Tag.
+ */
+namespace LogBinaryFormat
+{
+
+/** The first bytes of the file. */
+constexpr char FILE_MAGIC[8] = {'N', 'S', '3', 'L', 'O', 'G', 'B', '1'};
+
+/** The kinds of record. */
+enum Kind : uint8_t
+{
+    KIND_COMPONENT = 1, //!< A LogComponent definition.
+    KIND_LOG,           //!< A message of NS_LOG().
+    KIND_FUNCTION,      //!< A message of NS_LOG_FUNCTION().
+};
+
+/** The offset of the LogComponent id in the records. */
+constexpr std::size_t COMPONENT_OFFSET = 4 + 1;
+
+/** The record has a time. */
+constexpr uint8_t HAS_TIME = 0x01;
+/** The record has a context. */
+constexpr uint8_t HAS_NODE = 0x02;
+
+} // namespace LogBinaryFormat
+
+/**
+ * @ingroup logging
+ * The ring buffer of the LogBinarySink, and the thread writing it to
+ * the file.
+ */
+class LogBinaryRing
+{
+  public:
+    /**
+     * Constructor: open the file and start the writer thread.
+     *
+     * @param [in] filename The file to write.
+     * @param [in] capacity The size of the ring buffer, in bytes.
+     */
+    LogBinaryRing(const std::string& filename, std::size_t capacity);
+    /** Destructor: drain the ring buffer and stop the writer thread. */
+    ~LogBinaryRing();
+
+    /**
+     * Append a record to the ring buffer, waiting for space if needed.
+     *
+     * @param [in] component The LogComponent logging.
+     * @param [in,out] record The record, whose LogComponent id is set here.
+     */
+    void Push(const LogComponent* component, std::vector<char>& record);
+
+  private:
+    /**
+     * Append bytes to the ring buffer, in pieces as space frees up.
+     *
+     * @param [in] data The bytes.
+     * @param [in] size The number of bytes.
+     */
+    void Append(const char* data, std::size_t size);
+    /** The body of the writer thread. */
+    void Write();
+
+    std::ofstream m_file;                                    //!< The file written.
+    std::vector<char> m_ring;                                //!< The ring buffer.
+    uint64_t m_head{0};                                      //!< Total bytes appended.
+    uint64_t m_tail{0};                                      //!< Total bytes written.
+    bool m_stop{false};                                      //!< Stop the writer thread.
+    std::mutex m_producer;                                   //!< Serialise the Push calls.
+    std::mutex m_mutex;                                      //!< Guard the ring buffer state.
+    std::condition_variable m_data;                          //!< Signal bytes appended.
+    std::condition_variable m_space;                         //!< Signal bytes written.
+    std::unordered_map<const LogComponent*, uint32_t> m_ids; //!< LogComponent ids.
+    std::thread m_writer;                                    //!< The writer thread.
+};
+
+LogBinaryRing::LogBinaryRing(const std::string& filename, std::size_t capacity)
+    : m_file(filename, std::ios::binary | std::ios::trunc),
+      m_ring(capacity)
+{
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Could not open the binary log file \"" << filename << "\".");
+    }
+    NS_ABORT_MSG_IF(capacity == 0, "The binary log ring buffer can't be empty.");
+    m_file.write(LogBinaryFormat::FILE_MAGIC, sizeof(LogBinaryFormat::FILE_MAGIC));
+    m_writer = std::thread(&LogBinaryRing::Write, this);
+}
+
+LogBinaryRing::~LogBinaryRing()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_data.notify_one();
+    m_writer.join();
+}
+
+void
+LogBinaryRing::Push(const LogComponent* component, std::vector<char>& record)
+{
+    std::lock_guard producer(m_producer);
+
+    auto [it, added] = m_ids.try_emplace(component, static_cast<uint32_t>(m_ids.size()));
+    if (added)
+    {
+        std::string name = component->Name();
+        auto nameSize = static_cast<uint32_t>(name.size());
+        uint32_t size = 1 + sizeof(uint32_t) + sizeof(uint32_t) + nameSize;
+        std::vector<char> definition(sizeof(size) + size);
+        char* p = definition.data();
+        std::memcpy(p, &size, sizeof(size));
+        p[sizeof(size)] = LogBinaryFormat::KIND_COMPONENT;
+        std::memcpy(p + LogBinaryFormat::COMPONENT_OFFSET, &it->second, sizeof(uint32_t));
+        std::memcpy(p + LogBinaryFormat::COMPONENT_OFFSET + 4, &nameSize, sizeof(nameSize));
+        std::memcpy(p + LogBinaryFormat::COMPONENT_OFFSET + 8, name.data(), nameSize);
+        Append(definition.data(), definition.size());
+    }
+    std::memcpy(record.data() + LogBinaryFormat::COMPONENT_OFFSET, &it->second, sizeof(uint32_t));
+    Append(record.data(), record.size());
+}
+
+void
+LogBinaryRing::Append(const char* data, std::size_t size)
+{
+    std::unique_lock lock(m_mutex);
+    while (size > 0)
+    {
+        m_space.wait(lock, [this] { return m_head - m_tail < m_ring.size(); });
+        std::size_t free = m_ring.size() - (m_head - m_tail);
+        std::size_t n = std::min(free, size);
+        std::size_t start = m_head % m_ring.size();
+        std::size_t first = std::min(n, m_ring.size() - start);
+        std::memcpy(m_ring.data() + start, data, first);
+        std::memcpy(m_ring.data(), data + first, n - first);
+        m_head += n;
+        data += n;
+        size -= n;
+        m_data.notify_one();
+    }
+}
+
+void
+LogBinaryRing::Write()
+{
+    std::unique_lock lock(m_mutex);
+    while (true)
+    {
+        m_data.wait(lock, [this] { return m_stop || m_head != m_tail; });
+        if (m_head == m_tail)
+        {
+            break;
+        }
+        // The producers only append past m_head, so the bytes up to it
+        // can be written without holding the lock
+        uint64_t head = m_head;
+        uint64_t tail = m_tail;
+        lock.unlock();
+        std::size_t start = tail % m_ring.size();
+        std::size_t n = head - tail;
+        std::size_t first = std::min(n, m_ring.size() - start);
+        m_file.write(m_ring.data() + start, first);
+        m_file.write(m_ring.data(), n - first);
+        lock.lock();
+        m_tail = head;
+        m_space.notify_all();
+    }
+    m_file.flush();
+}
+
+/**
+ * @ingroup logging
+ * The ring buffer of the open LogBinarySink.
+ */
+static LogBinaryRing* g_logBinaryRing = nullptr;
+
+/**
+ * @ingroup logging
+ * Open the LogBinarySink named by the \c NS_LOG_BINARY environment
+ * variable at startup, and close the LogBinarySink at exit.
+ */
+class LogBinarySinkInit
+{
+  public:
+    /** Constructor: open the LogBinarySink if \c NS_LOG_BINARY is set. */
+    LogBinarySinkInit()
+    {
+        auto [found, filename] = EnvironmentVariable::Get("NS_LOG_BINARY");
+        if (found && !filename.empty())
+        {
+            LogBinarySink::Open(filename);
+        }
+    }
+
+    /** Destructor: close the LogBinarySink. */
+    ~LogBinarySinkInit()
+    {
+        LogBinarySink::Close();
+    }
+};
+
+/** Open and close the LogBinarySink. */
+static LogBinarySinkInit g_logBinarySinkInit;
+
+/**
+ * @ingroup logging
+ * The stream of each thread, reused by the records so they don't
+ * allocate.
+ */
+static thread_local LogBinarySink::Stream t_logBinaryStream;
+
+/**
+ * @ingroup logging
+ * Whether a Record of this thread is using t_logBinaryStream, when an
+ * argument of a log message logs itself.
+ */
+static thread_local bool t_logBinaryStreamBusy = false;
+
+/* static */
+void
+LogBinarySink::Open(const std::string& filename, std::size_t capacity)
+{
+    Close();
+    g_logBinaryRing = new LogBinaryRing(filename, capacity);
+    m_open.store(true, std::memory_order_relaxed);
+}
+
+/* static */
+void
+LogBinarySink::Close()
+{
+    m_open.store(false, std::memory_order_relaxed);
+    delete g_logBinaryRing;
+    g_logBinaryRing = nullptr;
+}
+
+LogBinarySink::Stream::Stream()
+    : std::ostream(nullptr),
+      m_component(nullptr)
+{
+    rdbuf(&m_textBuffer);
+    // As the NS_LOG macros print to std::clog
+    setf(std::ios_base::boolalpha);
+    m_plainFlags = flags();
+}
+
+void
+LogBinarySink::Stream::Start(const LogComponent& component,
+                             uint8_t kind,
+                             uint32_t level,
+                             const char* function)
+{
+    m_component = &component;
+    m_buffer.clear();
+    m_textBuffer.m_text.clear();
+    flags(m_plainFlags);
+    width(0);
+    precision(6);
+    fill(' ');
+    clear();
+
+    for (auto prefix : {LOG_PREFIX_FUNC, LOG_PREFIX_TIME, LOG_PREFIX_NODE, LOG_PREFIX_LEVEL})
+    {
+        if (component.IsEnabled(prefix))
+        {
+            level |= prefix;
+        }
+    }
+    uint8_t flags = 0;
+    int64_t time = 0;
+    auto resolution = static_cast<uint8_t>(Time::GetResolution());
+    uint32_t context = Simulator::NO_CONTEXT;
+    // The printers are set while a simulator exists
+    if (LogGetTimePrinter() != nullptr)
+    {
+        flags |= LogBinaryFormat::HAS_TIME;
+        time = Simulator::Now().GetTimeStep();
+    }
+    if (LogGetNodePrinter() != nullptr)
+    {
+        flags |= LogBinaryFormat::HAS_NODE;
+        context = Simulator::GetContext();
+    }
+
+    uint32_t size = 0;
+    uint32_t id = 0;
+    const auto append = [this](const void* data, std::size_t n) {
+        auto p = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), p, p + n);
+    };
+    append(&size, sizeof(size));
+    append(&kind, sizeof(kind));
+    append(&id, sizeof(id));
+    append(&level, sizeof(level));
+    append(&flags, sizeof(flags));
+    append(&time, sizeof(time));
+    append(&resolution, sizeof(resolution));
+    append(&context, sizeof(context));
+    auto functionSize = static_cast<uint32_t>(std::strlen(function));
+    append(&functionSize, sizeof(functionSize));
+    append(function, functionSize);
+}
+
+void
+LogBinarySink::Stream::Finish()
+{
+    if (!m_textBuffer.m_text.empty())
+    {
+        PutText();
+    }
+    auto size = static_cast<uint32_t>(m_buffer.size() - sizeof(uint32_t));
+    std::memcpy(m_buffer.data(), &size, sizeof(size));
+    if (g_logBinaryRing != nullptr)
+    {
+        g_logBinaryRing->Push(m_component, m_buffer);
+    }
+}
+
+void
+LogBinarySink::Stream::Put(uint8_t tag, const void* data, std::size_t size)
+{
+    // Keep the text formatted before this value in order
+    if (!m_textBuffer.m_text.empty())
+    {
+        PutText();
+    }
+    m_buffer.push_back(static_cast<char>(tag));
+    auto p = static_cast<const char*>(data);
+    m_buffer.insert(m_buffer.end(), p, p + size);
+}
+
+void
+LogBinarySink::Stream::PutText()
+{
+    std::string& text = m_textBuffer.m_text;
+    auto size = static_cast<uint32_t>(text.size());
+    m_buffer.push_back(static_cast<char>(TAG_STRING));
+    auto p = reinterpret_cast<const char*>(&size);
+    m_buffer.insert(m_buffer.end(), p, p + sizeof(size));
+    m_buffer.insert(m_buffer.end(), text.begin(), text.end());
+    text.clear();
+}
+
+void
+LogBinarySink::Stream::PutString(std::string_view value)
+{
+    auto size = static_cast<uint32_t>(value.size());
+    Put(TAG_STRING, &size, sizeof(size));
+    m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+}
+
+LogBinarySink::Stream::TextBuffer::int_type
+LogBinarySink::Stream::TextBuffer::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        m_text.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+LogBinarySink::Stream::TextBuffer::xsputn(const char* s, std::streamsize n)
+{
+    m_text.append(s, n);
+    return n;
+}
+
+LogBinarySink::Record::Record(const LogComponent& component, uint32_t level, const char* function)
+{
+    Acquire();
+    m_stream->Start(component, LogBinaryFormat::KIND_LOG, level, function);
+}
+
+LogBinarySink::Record::Record(const LogComponent& component, const char* function)
+{
+    Acquire();
+    m_stream->Start(component, LogBinaryFormat::KIND_FUNCTION, LOG_FUNCTION, function);
+}
+
+LogBinarySink::Record::~Record()
+{
+    m_stream->Finish();
+    if (m_owned)
+    {
+        delete m_stream;
+    }
+    else
+    {
+        t_logBinaryStreamBusy = false;
+    }
+}
+
+void
+LogBinarySink::Record::Acquire()
+{
+    m_owned = t_logBinaryStreamBusy;
+    if (m_owned)
+    {
+        m_stream = new Stream;
+    }
+    else
+    {
+        t_logBinaryStreamBusy = true;
+        m_stream = &t_logBinaryStream;
+    }
+}
+
+/**
+ * @ingroup logging
+ * Print a time as DefaultTimePrinter() does.
+ *
+ * @param [in,out] os The output stream.
+ * @param [in] time The time.
+ */
+static void
+LogBinaryPrintTime(std::ostream& os, const Time& time)
+{
+    std::ios_base::fmtflags ff = os.flags();
+    std::streamsize oldPrecision = os.precision();
+    os << std::fixed;
+    switch (Time::GetResolution())
+    {
+    case Time::US:
+        os << std::setprecision(6);
+        break;
+    case Time::NS:
+        os << std::setprecision(9);
+        break;
+    case Time::PS:
+        os << std::setprecision(12);
+        break;
+    case Time::FS:
+        os << std::setprecision(15);
+        break;
+    default:
+        os << std::setprecision(5);
+    }
+    os << time.As(Time::S);
+    os << std::setprecision(oldPrecision);
+    os.flags(ff);
+}
+
+/* static */
+int64_t
+LogBinarySink::Decode(std::istream& is, std::ostream& os, bool allPrefixes)
+{
+    char magic[sizeof(LogBinaryFormat::FILE_MAGIC)];
+    if (!is.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, LogBinaryFormat::FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        return -1;
+    }
+
+    std::map<uint32_t, std::string> names;
+    std::vector<char> record;
+    int64_t count = 0;
+    uint32_t size;
+    while (is.read(reinterpret_cast<char*>(&size), sizeof(size)))
+    {
+        record.resize(size);
+        if (!is.read(record.data(), size))
+        {
+            return -1;
+        }
+        std::size_t offset = 0;
+        bool truncated = false;
+        const auto get = [&record, &offset, &truncated](void* data, std::size_t n) {
+            if (offset + n > record.size())
+            {
+                truncated = true;
+                return;
+            }
+            std::memcpy(data, record.data() + offset, n);
+            offset += n;
+        };
+        const auto getString = [&record, &offset, &truncated, &get]() {
+            uint32_t n = 0;
+            get(&n, sizeof(n));
+            if (truncated || offset + n > record.size())
+            {
+                truncated = true;
+                return std::string_view{};
+            }
+            std::string_view value(record.data() + offset, n);
+            offset += n;
+            return value;
+        };
+
+        uint8_t kind = 0;
+        uint32_t id = 0;
+        get(&kind, sizeof(kind));
+        get(&id, sizeof(id));
+        if (kind == LogBinaryFormat::KIND_COMPONENT)
+        {
+            names[id] = getString();
+            if (truncated)
+            {
+                return -1;
+            }
+            continue;
+        }
+
+        uint32_t level = 0;
+        uint8_t flags = 0;
+        int64_t time = 0;
+        uint8_t resolution = 0;
+        uint32_t context = 0;
+        get(&level, sizeof(level));
+        get(&flags, sizeof(flags));
+        get(&time, sizeof(time));
+        get(&resolution, sizeof(resolution));
+        get(&context, sizeof(context));
+        std::string_view function = getString();
+
+        std::ostringstream message;
+        message.setf(std::ios_base::boolalpha);
+        while (!truncated && offset < record.size())
+        {
+            uint8_t tag = 0;
+            get(&tag, sizeof(tag));
+            switch (tag)
+            {
+            case TAG_INT: {
+                int64_t v = 0;
+                get(&v, sizeof(v));
+                message << v;
+                break;
+            }
+            case TAG_UINT: {
+                uint64_t v = 0;
+                get(&v, sizeof(v));
+                message << v;
+                break;
+            }
+            case TAG_DOUBLE: {
+                double v = 0;
+                get(&v, sizeof(v));
+                message << v;
+                break;
+            }
+            case TAG_BOOL: {
+                bool v = false;
+                get(&v, sizeof(v));
+                message << v;
+                break;
+            }
+            case TAG_CHAR: {
+                char v = 0;
+                get(&v, sizeof(v));
+                message << v;
+                break;
+            }
+            case TAG_STRING:
+                message << getString();
+                break;
+            case TAG_POINTER: {
+                uint64_t v = 0;
+                get(&v, sizeof(v));
+                message << reinterpret_cast<const void*>(static_cast<uintptr_t>(v));
+                break;
+            }
+            default:
+                truncated = true;
+            }
+        }
+        if (truncated || names.find(id) == names.end())
+        {
+            return -1;
+        }
+
+        if (allPrefixes)
+        {
+            level |= LOG_PREFIX_ALL;
+        }
+        if ((level & LOG_PREFIX_TIME) && (flags & LogBinaryFormat::HAS_TIME))
+        {
+            if (resolution != Time::GetResolution())
+            {
+                Time::SetResolution(static_cast<Time::Unit>(resolution));
+            }
+            LogBinaryPrintTime(os, TimeStep(time));
+            os << " ";
+        }
+        if ((level & LOG_PREFIX_NODE) && (flags & LogBinaryFormat::HAS_NODE))
+        {
+            if (context == Simulator::NO_CONTEXT)
+            {
+                os << "-1";
+            }
+            else
+            {
+                os << context;
+            }
+            os << " ";
+        }
+        const std::string& name = names[id];
+        if (kind == LogBinaryFormat::KIND_FUNCTION)
+        {
+            os << name << ":" << function << "(" << message.str() << ")" << std::endl;
+        }
+        else
+        {
+            if (level & LOG_PREFIX_FUNC)
+            {
+                os << name << ":" << function << "(): ";
+            }
+            if (level & LOG_PREFIX_LEVEL)
+            {
+                os << "[" << LogComponent::GetLevelLabel(LogLevel(level & LOG_ALL)) << "] ";
+            }
+            os << message.str() << std::endl;
+        }
+        ++count;
+    }
+    return is.gcount() == 0 ? count : -1;
+}
+
+} // namespace ns3
@@ -0,0 +1,353 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef NS3_LOG_BINARY_SINK_H
+#define NS3_LOG_BINARY_SINK_H
+
+/**
+ * @file
+ * @ingroup logging
+ * ns3::LogBinarySink declaration.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class LogComponent;
+
+/**
+ * @ingroup logging
+ *
+ * An asynchronous binary sink for the NS_LOG macros.
+ *
+ * While the sink is open, the enabled NS_LOG statements do not format
+ * their messages: each statement encodes its arguments in binary into a
+ * record, and appends the record to a ring buffer.  A background thread
+ * drains the ring buffer to the file, so the simulation only waits when
+ * the ring buffer is full.  The file is turned back into the text the
+ * NS_LOG statements would have printed by Decode(), or by the
+ * \c log-binary-to-text program in \c utils.
+ *
+ * The sink is opened by Open(), or at startup by setting the
+ * \c NS_LOG_BINARY environment variable to the name of the file.
+ *
+ * Integers, floating point numbers, characters, booleans, strings and
+ * pointers are encoded in binary, see LOG_BINARY_ENCODED.  Any other
+ * argument, and any argument after it or after a manipulator, is
+ * formatted to text when logged, by the same \c operator<< as on
+ * \c std::clog.  The records hold the simulation time and context,
+ * which the decoder prints in the format of the default TimePrinter and
+ * NodePrinter.  The output of
+ * \c NS_LOG_APPEND_CONTEXT is not recorded.
+ *
+ * The file is in host byte order.
+ */
+class LogBinarySink
+{
+  public:
+    /**
+     * Open the sink, closing it first if open.
+     *
+     * @param [in] filename The file to write.
+     * @param [in] capacity The size of the ring buffer, in bytes.
+     */
+    static void Open(const std::string& filename, std::size_t capacity = 1 << 22);
+    /** Drain the ring buffer to the file, and close the sink. */
+    static void Close();
+    /**
+     * Check if the sink is open.
+     *
+     * @return \c true if the NS_LOG statements go to the sink.
+     */
+    static bool IsOpen()
+    {
+        return m_open.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Decode a file written by the sink.
+     *
+     * @param [in] is The file written by the sink.
+     * @param [in,out] os Where to print the log messages.
+     * @param [in] allPrefixes Print all the prefixes, instead of those
+     *             enabled when the messages were logged.
+     * @return The number of log messages decoded, or -1 if \p is is not
+     *         a file written by the sink, or is truncated.
+     */
+    static int64_t Decode(std::istream& is, std::ostream& os, bool allPrefixes = false);
+
+    /**
+     * The stream a log message is encoded to.
+     *
+     * The values of the types encoded in binary are inserted by
+     * operator<<(LogBinarySink::Stream&, const T&) while the stream has
+     * the default format; any other value is inserted by the
+     * \c std::ostream insertion operators, and formatted to text.
+     */
+    class Stream : public std::ostream
+    {
+      public:
+        /** Constructor. */
+        Stream();
+
+        /**
+         * Start a record.
+         *
+         * @param [in] component The LogComponent logging the message.
+         * @param [in] kind The kind of record.
+         * @param [in] level The level of the message.
+         * @param [in] function The name of the function logging.
+         */
+        void Start(const LogComponent& component,
+                   uint8_t kind,
+                   uint32_t level,
+                   const char* function);
+        /** Append the record to the ring buffer. */
+        void Finish();
+
+        /**
+         * Encode a value in binary, or format it to text if the format
+         * of the stream is not the default one.
+         *
+         * @tparam T \deduced The type of the value.
+         * @param [in] value The value.
+         */
+        template <typename T>
+        void Encode(const T& value);
+
+      private:
+        /** The stream buffer collecting the text formatted. */
+        class TextBuffer : public std::streambuf
+        {
+          public:
+            std::string m_text; //!< The text formatted since the last value encoded.
+
+          protected:
+            int_type overflow(int_type c) override;
+            std::streamsize xsputn(const char* s, std::streamsize n) override;
+        };
+
+        /**
+         * Append a value to the record.
+         *
+         * @param [in] tag The type of the value.
+         * @param [in] data The value.
+         * @param [in] size The size of the value.
+         */
+        void Put(uint8_t tag, const void* data, std::size_t size);
+        /**
+         * Append a string to the record.
+         *
+         * @param [in] value The string.
+         */
+        void PutString(std::string_view value);
+        /** Append the text formatted so far to the record, as a string. */
+        void PutText();
+
+        TextBuffer m_textBuffer;              //!< The text formatted.
+        std::vector<char> m_buffer;           //!< The record encoded so far.
+        const LogComponent* m_component;      //!< The LogComponent logging.
+        std::ios_base::fmtflags m_plainFlags; //!< The default format flags.
+    };
+
+    /**
+     * A log message being encoded.
+     *
+     * The message is appended to the ring buffer when the Record is
+     * destroyed, at the end of the NS_LOG statement.
+     */
+    class Record
+    {
+      public:
+        /**
+         * Constructor for the messages of NS_LOG().
+         *
+         * @param [in] component The LogComponent logging the message.
+         * @param [in] level The level of the message.
+         * @param [in] function The name of the function logging.
+         */
+        Record(const LogComponent& component, uint32_t level, const char* function);
+        /**
+         * Constructor for the messages of NS_LOG_FUNCTION().
+         *
+         * @param [in] component The LogComponent logging the message.
+         * @param [in] function The name of the function logging.
+         */
+        Record(const LogComponent& component, const char* function);
+        /** Destructor: append the record to the ring buffer. */
+        ~Record();
+
+        // Delete copy constructor and assignment operator to avoid misuse
+        Record(const Record&) = delete;
+        Record& operator=(const Record&) = delete;
+
+        /**
+         * Get the stream the message is encoded to.
+         *
+         * @return The stream.
+         */
+        Stream& GetStream()
+        {
+            return *m_stream;
+        }
+
+      private:
+        /** Get a stream, the one of this thread unless it is in use. */
+        void Acquire();
+
+        Stream* m_stream; //!< The stream the message is encoded to.
+        bool m_owned;     //!< Whether m_stream is owned by this Record.
+    };
+
+    /** The types of the values in the records. */
+    enum Tag : uint8_t
+    {
+        TAG_INT = 1, //!< int64_t.
+        TAG_UINT,    //!< uint64_t.
+        TAG_DOUBLE,  //!< double.
+        TAG_BOOL,    //!< bool.
+        TAG_CHAR,    //!< char.
+        TAG_STRING,  //!< String, uint32_t size then the characters.
+        TAG_POINTER, //!< Pointer, as a uint64_t.
+    };
+
+  private:
+    /** Whether the sink is open. */
+    inline static std::atomic<bool> m_open{false};
+};
+
+/**
+ * @ingroup logging
+ * Check for an \c operator<< of \c std::ostream and \p T which is not a
+ * member of \c std::ostream.
+ *
+ * @tparam T The type inserted.
+ */
+template <typename T, typename = void>
+struct LogBinaryHasFreeInsertion : std::false_type
+{
+};
+
+/** @copydoc LogBinaryHasFreeInsertion */
+template <typename T>
+struct LogBinaryHasFreeInsertion<
+    T,
+    std::void_t<decltype(operator<<(std::declval<std::ostream&>(), std::declval<const T&>()))>>
+    : std::true_type
+{
+};
+
+/**
+ * @ingroup logging
+ * Whether the LogBinarySink encodes the values of type \p T in binary:
+ * the arithmetic types, the strings, and the pointers to objects without
+ * an \c operator<< of their own.
+ *
+ * @tparam T The decayed type of the value.
+ */
+template <typename T>
+constexpr bool LOG_BINARY_ENCODED =
+    std::is_same_v<T, bool> || std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, short> ||
+    std::is_same_v<T, unsigned short> || std::is_same_v<T, int> || std::is_same_v<T, unsigned> ||
+    std::is_same_v<T, long> || std::is_same_v<T, unsigned long> || std::is_same_v<T, long long> ||
+    std::is_same_v<T, unsigned long long> || std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, char*> || std::is_same_v<T, const char*> ||
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    (std::is_pointer_v<T> && std::is_object_v<std::remove_pointer_t<T>> &&
+     !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char> &&
+     !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, signed char> &&
+     !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, unsigned char> &&
+     !LogBinaryHasFreeInsertion<T>::value);
+
+/**
+ * @ingroup logging
+ * Insert a value encoded in binary in a log message.
+ *
+ * @tparam T \deduced The type of the value.
+ * @param [in,out] stream The stream of the log message.
+ * @param [in] value The value.
+ * @return The stream, so it's chainable.
+ */
+template <typename T, std::enable_if_t<LOG_BINARY_ENCODED<std::decay_t<T>>, int> = 0>
+LogBinarySink::Stream&
+operator<<(LogBinarySink::Stream& stream, const T& value)
+{
+    stream.Encode(value);
+    return stream;
+}
+
+template <typename T>
+void
+LogBinarySink::Stream::Encode(const T& value)
+{
+    using V = std::decay_t<T>;
+    if (flags() != m_plainFlags || width() != 0 || precision() != 6)
+    {
+        static_cast<std::ostream&>(*this) << value;
+    }
+    else if constexpr (std::is_same_v<V, bool>)
+    {
+        Put(TAG_BOOL, &value, 1);
+    }
+    else if constexpr (std::is_same_v<V, char> || std::is_same_v<V, signed char> ||
+                       std::is_same_v<V, unsigned char>)
+    {
+        Put(TAG_CHAR, &value, 1);
+    }
+    else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+    {
+        int64_t v = value;
+        Put(TAG_INT, &v, sizeof(v));
+    }
+    else if constexpr (std::is_integral_v<V>)
+    {
+        uint64_t v = value;
+        Put(TAG_UINT, &v, sizeof(v));
+    }
+    else if constexpr (std::is_floating_point_v<V>)
+    {
+        // A float prints as the double of the same value
+        double v = value;
+        Put(TAG_DOUBLE, &v, sizeof(v));
+    }
+    else if constexpr (std::is_array_v<T>)
+    {
+        PutString(value);
+    }
+    else if constexpr (std::is_same_v<V, char*> || std::is_same_v<V, const char*>)
+    {
+        if (value == nullptr)
+        {
+            static_cast<std::ostream&>(*this) << static_cast<const char*>(value);
+        }
+        else
+        {
+            PutString(value);
+        }
+    }
+    else if constexpr (std::is_pointer_v<V>)
+    {
+        auto v = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+        Put(TAG_POINTER, &v, sizeof(v));
+    }
+    else
+    {
+        PutString(value);
+    }
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_BINARY_SINK_H */
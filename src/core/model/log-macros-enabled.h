@@ -148,6 +148,19 @@
 #define NS_LOG_CONDITION
 #endif
 
+/**
+ * @ingroup logging
+ * Check if the log component in scope compiles in a log level.
+ *
+ * This is a constant expression, \c true for all the levels unless the
+ * build is configured with \c NS3_LOG_COMPONENTS; see
+ * CompiledLogComponent.
+ *
+ * @param [in] level The log level.
+ */
+#define NS_LOG_COMPILED_IN(level)                                                                  \
+    ((std::remove_reference_t<decltype(g_log)>::COMPILED & (level)) != 0)
+
 /**
  * @ingroup logging
  *
@@ -171,16 +184,27 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(level))                                                                \
+        if constexpr (NS_LOG_COMPILED_IN(level))                                                   \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            NS_LOG_APPEND_FUNC_PREFIX;                                                             \
-            NS_LOG_APPEND_LEVEL_PREFIX(level);                                                     \
-            auto flags = std::clog.setf(std::ios_base::boolalpha);                                 \
-            std::clog << msg << std::endl;                                                         \
-            std::clog.flags(flags);                                                                \
+            if (g_log.IsEnabled(level))                                                            \
+            {                                                                                      \
+                if (ns3::LogBinarySink::IsOpen())                                                  \
+                {                                                                                  \
+                    ns3::LogBinarySink::Record record(g_log, level, __FUNCTION__);                 \
+                    record.GetStream() << msg;                                                     \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    NS_LOG_APPEND_FUNC_PREFIX;                                                     \
+                    NS_LOG_APPEND_LEVEL_PREFIX(level);                                             \
+                    auto flags = std::clog.setf(std::ios_base::boolalpha);                         \
+                    std::clog << msg << std::endl;                                                 \
+                    std::clog.flags(flags);                                                        \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -196,12 +220,22 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if constexpr (NS_LOG_COMPILED_IN(ns3::LOG_FUNCTION))                                       \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;                 \
+            if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                \
+            {                                                                                      \
+                if (ns3::LogBinarySink::IsOpen())                                                  \
+                {                                                                                  \
+                    ns3::LogBinarySink::Record record(g_log, __FUNCTION__);                        \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    std::clog << g_log.Name() << ":" << __FUNCTION__ << "()" << std::endl;         \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
@@ -230,16 +264,27 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if constexpr (NS_LOG_COMPILED_IN(ns3::LOG_FUNCTION))                                       \
         {                                                                                          \
-            NS_LOG_APPEND_TIME_PREFIX;                                                             \
-            NS_LOG_APPEND_NODE_PREFIX;                                                             \
-            NS_LOG_APPEND_CONTEXT;                                                                 \
-            std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                               \
-            auto flags = std::clog.setf(std::ios_base::boolalpha);                                 \
-            ns3::ParameterLogger(std::clog) << parameters;                                         \
-            std::clog.flags(flags);                                                                \
-            std::clog << ")" << std::endl;                                                         \
+            if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                \
+            {                                                                                      \
+                if (ns3::LogBinarySink::IsOpen())                                                  \
+                {                                                                                  \
+                    ns3::LogBinarySink::Record record(g_log, __FUNCTION__);                        \
+                    ns3::ParameterLogger(record.GetStream()) << parameters;                        \
+                }                                                                                  \
+                else                                                                               \
+                {                                                                                  \
+                    NS_LOG_APPEND_TIME_PREFIX;                                                     \
+                    NS_LOG_APPEND_NODE_PREFIX;                                                     \
+                    NS_LOG_APPEND_CONTEXT;                                                         \
+                    std::clog << g_log.Name() << ":" << __FUNCTION__ << "(";                       \
+                    auto flags = std::clog.setf(std::ios_base::boolalpha);                         \
+                    ns3::ParameterLogger(std::clog) << parameters;                                 \
+                    std::clog.flags(flags);                                                        \
+                    std::clog << ")" << std::endl;                                                 \
+                }                                                                                  \
+            }                                                                                      \
         }                                                                                          \
     } while (false)
 
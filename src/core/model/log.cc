@@ -10,6 +10,7 @@
 #include "assert.h"
 #include "environment-variable.h"
 #include "fatal-error.h"
+#include "startup-profile.h"
 #include "string.h"
 
 #include "ns3/core-config.h"
@@ -37,34 +38,14 @@
 namespace
 {
 /** Mapping of log level text names to values. */
-const std::map<std::string, ns3::LogLevel> LOG_LABEL_LEVELS = {
-    // clang-format off
-        {"none",           ns3::LOG_NONE},
-        {"error",          ns3::LOG_ERROR},
-        {"level_error",    ns3::LOG_LEVEL_ERROR},
-        {"warn",           ns3::LOG_WARN},
-        {"level_warn",     ns3::LOG_LEVEL_WARN},
-        {"debug",          ns3::LOG_DEBUG},
-        {"level_debug",    ns3::LOG_LEVEL_DEBUG},
-        {"info",           ns3::LOG_INFO},
-        {"level_info",     ns3::LOG_LEVEL_INFO},
-        {"function",       ns3::LOG_FUNCTION},
-        {"level_function", ns3::LOG_LEVEL_FUNCTION},
-        {"logic",          ns3::LOG_LOGIC},
-        {"level_logic",    ns3::LOG_LEVEL_LOGIC},
-        {"all",            ns3::LOG_ALL},
-        {"level_all",      ns3::LOG_LEVEL_ALL},
-        {"func",           ns3::LOG_PREFIX_FUNC},
-        {"prefix_func",    ns3::LOG_PREFIX_FUNC},
-        {"time",           ns3::LOG_PREFIX_TIME},
-        {"prefix_time",    ns3::LOG_PREFIX_TIME},
-        {"node",           ns3::LOG_PREFIX_NODE},
-        {"prefix_node",    ns3::LOG_PREFIX_NODE},
-        {"level",          ns3::LOG_PREFIX_LEVEL},
-        {"prefix_level",   ns3::LOG_PREFIX_LEVEL},
-        {"prefix_all",     ns3::LOG_PREFIX_ALL}
-    // clang-format on
-};
+const std::map<std::string, ns3::LogLevel> LOG_LABEL_LEVELS = {[]() {
+    std::map<std::string, ns3::LogLevel> levels;
+    for (const auto& [label, lev] : ns3::LOG_LEVEL_NAMES)
+    {
+        levels.emplace(label, lev);
+    }
+    return levels;
+}()};
 
 /** Inverse mapping of level values to log level text names. */
 const std::map<ns3::LogLevel, std::string> LOG_LEVEL_LABELS = {[]() {
@@ -153,6 +134,7 @@ LogComponent::LogComponent(const std::string& name,
       m_name(name),
       m_file(file)
 {
+    StartupProfile::Timer timer(StartupProfile::LOG_COMPONENT);
     // Check if we're mentioned in NS_LOG, and set our flags appropriately
     EnvVarCheck();
 
@@ -186,6 +168,11 @@ GetLogComponent(const std::string name)
 void
 LogComponent::EnvVarCheck()
 {
+    if (!EnvironmentVariable::Get("NS_LOG").first)
+    {
+        // the usual case, checked first as every component does it at startup
+        return;
+    }
     auto [found, value] = EnvironmentVariable::Get("NS_LOG", m_name, ":");
     if (!found)
     {
@@ -509,22 +496,4 @@ LogGetNodePrinter()
     return g_logNodePrinter;
 }
 
-ParameterLogger::ParameterLogger(std::ostream& os)
-    : m_os(os)
-{
-}
-
-void
-ParameterLogger::CommaRest()
-{
-    if (m_first)
-    {
-        m_first = false;
-    }
-    else
-    {
-        m_os << ", ";
-    }
-}
-
 } // namespace ns3
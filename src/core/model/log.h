@@ -9,16 +9,20 @@
 #ifndef NS3_LOG_H
 #define NS3_LOG_H
 
+#include "log-binary-sink.h"
 #include "log-macros-disabled.h"
 #include "log-macros-enabled.h"
 #include "node-printer.h"
 #include "time-printer.h"
 
 #include <iostream>
+#include <stdexcept>
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 /**
@@ -111,6 +115,103 @@ enum LogLevel
     LOG_PREFIX_ALL = 0xf0000000    //!< All prefixes.
 };
 
+/** The text names of the log levels and prefixes, as used in \c NS_LOG. */
+constexpr std::pair<std::string_view, LogLevel> LOG_LEVEL_NAMES[] = {
+    // clang-format off
+    {"none",           LOG_NONE},
+    {"error",          LOG_ERROR},
+    {"level_error",    LOG_LEVEL_ERROR},
+    {"warn",           LOG_WARN},
+    {"level_warn",     LOG_LEVEL_WARN},
+    {"debug",          LOG_DEBUG},
+    {"level_debug",    LOG_LEVEL_DEBUG},
+    {"info",           LOG_INFO},
+    {"level_info",     LOG_LEVEL_INFO},
+    {"function",       LOG_FUNCTION},
+    {"level_function", LOG_LEVEL_FUNCTION},
+    {"logic",          LOG_LOGIC},
+    {"level_logic",    LOG_LEVEL_LOGIC},
+    {"all",            LOG_ALL},
+    {"level_all",      LOG_LEVEL_ALL},
+    {"func",           LOG_PREFIX_FUNC},
+    {"prefix_func",    LOG_PREFIX_FUNC},
+    {"time",           LOG_PREFIX_TIME},
+    {"prefix_time",    LOG_PREFIX_TIME},
+    {"node",           LOG_PREFIX_NODE},
+    {"prefix_node",    LOG_PREFIX_NODE},
+    {"level",          LOG_PREFIX_LEVEL},
+    {"prefix_level",   LOG_PREFIX_LEVEL},
+    {"prefix_all",     LOG_PREFIX_ALL}
+    // clang-format on
+};
+
+/**
+ * Get the log levels compiled in for a log component.
+ *
+ * The \p spec has the syntax of the \c NS_LOG environment variable,
+ * where the options select the levels compiled in, all of them if there
+ * are none; the prefixes are always compiled in.  The components not
+ * in \p spec have no level compiled in.
+ *
+ * This is evaluated at compile time for each log component when the
+ * build is configured with \c NS3_LOG_COMPONENTS, where an unknown
+ * option is a compile error.
+ *
+ * @param [in] spec The log components and levels compiled in.
+ * @param [in] name The log component name.
+ * @return The levels of \p name compiled in.
+ */
+constexpr uint32_t
+LogCompiledLevels(std::string_view spec, std::string_view name)
+{
+    uint32_t levels = LOG_NONE;
+    while (!spec.empty())
+    {
+        std::size_t end = spec.find(':');
+        std::string_view entry = spec.substr(0, end);
+        spec = (end == std::string_view::npos) ? std::string_view{} : spec.substr(end + 1);
+
+        std::size_t equal = entry.find('=');
+        std::string_view component = entry.substr(0, equal);
+        if (component != name && component != "*" && component != "***")
+        {
+            continue;
+        }
+        std::string_view options =
+            (equal == std::string_view::npos) ? std::string_view{} : entry.substr(equal + 1);
+        if (options.empty())
+        {
+            levels |= LOG_LEVEL_ALL;
+        }
+        while (!options.empty())
+        {
+            std::size_t pipe = options.find('|');
+            std::string_view option = options.substr(0, pipe);
+            options =
+                (pipe == std::string_view::npos) ? std::string_view{} : options.substr(pipe + 1);
+            if (option == "*" || option == "**")
+            {
+                levels |= LOG_LEVEL_ALL;
+                continue;
+            }
+            bool found = false;
+            for (const auto& [label, level] : LOG_LEVEL_NAMES)
+            {
+                if (option == label)
+                {
+                    levels |= level & LOG_LEVEL_ALL;
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                throw std::invalid_argument("unknown log level in NS3_LOG_COMPONENTS");
+            }
+        }
+    }
+    return levels;
+}
+
 /**
  * Enable the logging output associated with that log component.
  *
@@ -188,8 +289,7 @@ void LogComponentDisableAll(LogLevel level);
  *
  * @param [in] name The log component name.
  */
-#define NS_LOG_COMPONENT_DEFINE(name)                                                              \
-    static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__)
+#define NS_LOG_COMPONENT_DEFINE(name) static NS_LOG_COMPONENT_TYPE(name) g_log(name, __FILE__)
 
 /**
  * Define a logging component with a mask.
@@ -200,7 +300,23 @@ void LogComponentDisableAll(LogLevel level);
  * @param [in] mask The default mask.
  */
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                                                   \
-    static ns3::LogComponent g_log = ns3::LogComponent(name, __FILE__, mask)
+    static NS_LOG_COMPONENT_TYPE(name) g_log(name, __FILE__, mask)
+
+#ifdef NS3_LOG_COMPILED
+/**
+ * The type of the log component defined by NS_LOG_COMPONENT_DEFINE().
+ *
+ * When the build selects the log components and levels compiled in,
+ * with \c NS3_LOG_COMPONENTS, this is a CompiledLogComponent, and the
+ * NS_LOG macros of the levels not selected compile to nothing.
+ *
+ * @param [in] name The log component name.
+ */
+#define NS_LOG_COMPONENT_TYPE(name)                                                                \
+    ns3::CompiledLogComponent<ns3::LogCompiledLevels(NS3_LOG_COMPILED, name)>
+#else
+#define NS_LOG_COMPONENT_TYPE(name) ns3::LogComponent
+#endif
 
 /**
  * Declare a reference to a Log component.
@@ -326,6 +442,13 @@ class LogComponent
      *                  functions which help implement the logging facility.
      */
     LogComponent(const std::string& name, const std::string& file, const LogLevel mask = LOG_NONE);
+
+    /**
+     * The levels and prefixes the NS_LOG macros compile in: all of them,
+     * unless this is a CompiledLogComponent.
+     */
+    static constexpr uint32_t COMPILED = LOG_ALL | LOG_PREFIX_ALL;
+
     /**
      * Check if this LogComponent is enabled for \c level
      *
@@ -412,6 +535,49 @@ class LogComponent
 
 }; // class LogComponent
 
+/**
+ * A LogComponent with the levels compiled in known at compile time.
+ *
+ * NS_LOG_COMPONENT_DEFINE() defines these when the build is configured
+ * with \c NS3_LOG_COMPONENTS.  The levels not compiled in are masked,
+ * so they can't be enabled at run time either.
+ *
+ * @tparam Levels The levels compiled in, see LogCompiledLevels().
+ */
+template <uint32_t Levels>
+class CompiledLogComponent : public LogComponent
+{
+  public:
+    /** The levels compiled in, and all the prefixes. */
+    static constexpr uint32_t COMPILED = Levels | LOG_PREFIX_ALL;
+
+    /**
+     * Constructor.
+     *
+     * @param [in] name The user-visible name for this component.
+     * @param [in] file The source code file which defined this LogComponent.
+     * @param [in] mask LogLevels blocked for this LogComponent.
+     */
+    CompiledLogComponent(const std::string& name,
+                         const std::string& file,
+                         const LogLevel mask = LOG_NONE)
+        : LogComponent(name, file, LogLevel(mask | (LOG_ALL & ~Levels)))
+    {
+    }
+
+    /**
+     * Check if this LogComponent is enabled for \c level,
+     * at compile time if \c level is not compiled in.
+     *
+     * @param [in] level The level to check for.
+     * @return \c true if we are enabled at \c level.
+     */
+    bool IsEnabled(const LogLevel level) const
+    {
+        return (COMPILED & level) && LogComponent::IsEnabled(level);
+    }
+};
+
 /**
  * Get the LogComponent registered with the given name.
  *
@@ -422,7 +588,11 @@ LogComponent& GetLogComponent(const std::string name);
 
 /**
  * Insert `, ` when streaming function arguments.
+ *
+ * @tparam Stream \deduced The underlying output stream type, either
+ *         \c std::ostream or LogBinarySink::Record.
  */
+template <typename Stream = std::ostream>
 class ParameterLogger
 {
   public:
@@ -431,7 +601,10 @@ class ParameterLogger
      *
      * @param [in] os Underlying output stream.
      */
-    ParameterLogger(std::ostream& os);
+    ParameterLogger(Stream& os)
+        : m_os(os)
+    {
+    }
 
     /**
      * Write a function parameter on the output stream,
@@ -454,15 +627,26 @@ class ParameterLogger
 
   private:
     /** Add `, ` before every parameter after the first. */
-    void CommaRest();
+    void CommaRest()
+    {
+        if (m_first)
+        {
+            m_first = false;
+        }
+        else
+        {
+            m_os << ", ";
+        }
+    }
 
     bool m_first{true}; //!< First argument flag, doesn't get `, `.
-    std::ostream& m_os; //!< Underlying output stream.
+    Stream& m_os;       //!< Underlying output stream.
 };
 
+template <typename Stream>
 template <typename T>
-ParameterLogger&
-ParameterLogger::operator<<(const T& param)
+ParameterLogger<Stream>&
+ParameterLogger<Stream>::operator<<(const T& param)
 {
     CommaRest();
 
@@ -483,9 +667,10 @@ ParameterLogger::operator<<(const T& param)
     return *this;
 }
 
+template <typename Stream>
 template <typename T>
-ParameterLogger&
-ParameterLogger::operator<<(const std::vector<T>& vector)
+ParameterLogger<Stream>&
+ParameterLogger<Stream>::operator<<(const std::vector<T>& vector)
 {
     for (const auto& i : vector)
     {
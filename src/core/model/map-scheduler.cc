@@ -92,6 +92,20 @@ MapScheduler::RemoveNext()
     return ev;
 }
 
+void
+MapScheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    auto begin = m_list.begin();
+    NS_ASSERT(begin != m_list.end());
+    auto end = begin;
+    for (; end != m_list.end() && end->first.m_ts == begin->first.m_ts; ++end)
+    {
+        events.push_back({end->second, end->first});
+    }
+    m_list.erase(begin, end);
+}
+
 void
 MapScheduler::Remove(const Event& ev)
 {
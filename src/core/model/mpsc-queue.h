@@ -0,0 +1,210 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "assert.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * @ingroup simulator
+ * @brief A bounded, lock-free, multiple producer, single consumer queue.
+ *
+ * Used by the simulator implementations to hand events scheduled from
+ * other threads over to the simulation thread, without a lock and
+ * without allocating memory per element.
+ *
+ * This is the bounded queue by Dmitry Vyukov: every cell of a ring
+ * buffer carries a sequence number telling whether it is free for the
+ * producer holding a given position, or holds the element for the
+ * consumer.  Producers claim positions with a compare-and-swap; the
+ * single consumer needs no read-modify-write operation at all.
+ *
+ * Push() fails instead of blocking when the queue is full, leaving the
+ * caller to decide how to handle the overflow.
+ *
+ * @tparam T \explicit The element type, which must be default
+ *         constructible and copy assignable.
+ */
+template <typename T>
+class MpscQueue
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * @param [in] capacity The maximum number of elements, rounded up to
+     *             a power of two.
+     */
+    explicit MpscQueue(uint32_t capacity);
+
+    /** No copies: the cells hold atomics. */
+    MpscQueue(const MpscQueue&) = delete;
+    /**
+     * No copies.
+     * @returns The queue.
+     */
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Add an element, from any thread.
+     *
+     * @param [in] value The element.
+     * @returns \c false if the queue is full.
+     */
+    bool Push(const T& value);
+
+    /**
+     * Remove the oldest element, from the consumer thread only.
+     *
+     * An element whose Push() has not completed yet is not visible,
+     * even if later elements are.
+     *
+     * @param [out] value The element.
+     * @returns \c false if no element is available.
+     */
+    bool Pop(T& value);
+
+    /**
+     * Check whether the queue is empty, from the consumer thread only.
+     *
+     * Unlike a failed Pop(), this also accounts for elements whose
+     * Push() is still in progress.
+     *
+     * @returns \c true if no element is queued or being pushed.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @returns The capacity of the queue.
+     */
+    uint32_t GetCapacity() const;
+
+  private:
+    /** A cell of the ring buffer. */
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence; /**< Position this cell is ready for. */
+        T value;                        /**< The element. */
+    };
+
+    /**
+     * Keep the positions of producers and consumer on separate cache
+     * lines, so they do not invalidate each other.
+     */
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> m_cells;                          /**< The ring buffer. */
+    uint64_t m_mask;                                          /**< Capacity minus one. */
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_pushPosition; /**< Next position to push. */
+    alignas(CACHE_LINE) uint64_t m_popPosition;               /**< Next position to pop. */
+};
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+template <typename T>
+MpscQueue<T>::MpscQueue(uint32_t capacity)
+    : m_pushPosition(0),
+      m_popPosition(0)
+{
+    NS_ASSERT_MSG(capacity > 0, "MpscQueue capacity must be positive");
+    uint64_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    m_cells = std::make_unique<Cell[]>(size);
+    m_mask = size - 1;
+    for (uint64_t i = 0; i < size; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Push(const T& value)
+{
+    uint64_t position = m_pushPosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = m_cells[position & m_mask];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - position);
+        if (diff == 0)
+        {
+            // the cell is free for this position: try to claim it
+            if (m_pushPosition.compare_exchange_weak(position,
+                                                     position + 1,
+                                                     std::memory_order_relaxed))
+            {
+                cell.value = value;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+            // position was reloaded by the failed compare-and-swap
+        }
+        else if (diff < 0)
+        {
+            // the cell still holds the element pushed one lap ago
+            return false;
+        }
+        else
+        {
+            // another producer claimed this position first
+            position = m_pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop(T& value)
+{
+    Cell& cell = m_cells[m_popPosition & m_mask];
+    uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != m_popPosition + 1)
+    {
+        return false;
+    }
+    value = cell.value;
+    // free the cell for the producer one lap ahead
+    cell.sequence.store(m_popPosition + m_mask + 1, std::memory_order_release);
+    ++m_popPosition;
+    return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty() const
+{
+    return m_pushPosition.load(std::memory_order_acquire) == m_popPosition;
+}
+
+template <typename T>
+uint32_t
+MpscQueue<T>::GetCapacity() const
+{
+    return static_cast<uint32_t>(m_mask + 1);
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
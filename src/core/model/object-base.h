@@ -31,11 +31,20 @@
  *
  * If the class is in a namespace, then the macro call should also be
  * in the namespace.
+ *
+ * The registration is deferred until the TypeId is looked up, see
+ * TypeId::DeferRegistration(), so it is cheapest when the class is
+ * named like the last part of its TypeId name.
  */
 #define NS_OBJECT_ENSURE_REGISTERED(type)                                                          \
     static struct Object##type##RegistrationClass                                                  \
     {                                                                                              \
         Object##type##RegistrationClass()                                                          \
+        {                                                                                          \
+            ns3::TypeId::DeferRegistration(#type, &Register);                                      \
+        }                                                                                          \
+                                                                                                   \
+        static void Register()                                                                     \
         {                                                                                          \
             NS_WARNING_PUSH_DEPRECATED;                                                            \
             ns3::TypeId tid = type::GetTypeId();                                                   \
@@ -75,6 +84,11 @@
     static struct Object##type##param##RegistrationClass                                           \
     {                                                                                              \
         Object##type##param##RegistrationClass()                                                   \
+        {                                                                                          \
+            ns3::TypeId::DeferRegistration(#type "<" #param ">", &Register);                       \
+        }                                                                                          \
+                                                                                                   \
+        static void Register()                                                                     \
         {                                                                                          \
             ns3::TypeId tid = type<param>::GetTypeId();                                            \
             tid.SetSize(sizeof(type<param>));                                                      \
@@ -113,6 +127,11 @@
     static struct Object##type##param1##param2##RegistrationClass                                  \
     {                                                                                              \
         Object##type##param1##param2##RegistrationClass()                                          \
+        {                                                                                          \
+            ns3::TypeId::DeferRegistration(#type "<" #param1 "," #param2 ">", &Register);          \
+        }                                                                                          \
+                                                                                                   \
+        static void Register()                                                                     \
         {                                                                                          \
             ns3::TypeId tid = type<param1, param2>::GetTypeId();                                   \
             tid.SetSize(sizeof(type<param1, param2>));                                             \
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <iostream>
 #include <numbers>
+#include <vector>
 
 /**
  * @file
@@ -100,6 +101,15 @@ RandomVariableStream::GetInteger()
     return value;
 }
 
+void
+RandomVariableStream::GetValues(std::span<double> values)
+{
+    for (double& value : values)
+    {
+        value = GetValue();
+    }
+}
+
 void
 RandomVariableStream::SetStream(int64_t stream)
 {
@@ -210,6 +220,22 @@ UniformRandomVariable::GetValue()
     return GetValue(m_min, m_max);
 }
 
+void
+UniformRandomVariable::GetValues(std::span<double> values)
+{
+    Peek()->RandU01(values);
+    for (double& v : values)
+    {
+        v = m_min + v * (m_max - m_min);
+        if (IsAntithetic())
+        {
+            v = m_min + (m_max - v);
+        }
+    }
+    NS_LOG_DEBUG(values.size() << " values, stream: " << GetStream() << " min: " << m_min
+                               << " max: " << m_max);
+}
+
 uint32_t
 UniformRandomVariable::GetInteger()
 {
@@ -443,6 +469,37 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(std::span<double> values)
+{
+    // One uniform per value, drawn in place, unless the bound rejects
+    // some: the next ones are then those of the following values, and
+    // the last ones are drawn after the batch, as GetValue() would.
+    // Each value consumes at least its own uniform, so never overwrites
+    // one not consumed yet.
+    Peek()->RandU01(values);
+    std::size_t next = 0;
+    for (double& value : values)
+    {
+        while (true)
+        {
+            double v = next < values.size() ? values[next++] : Peek()->RandU01();
+            if (IsAntithetic())
+            {
+                v = (1 - v);
+            }
+            double r = -m_mean * std::log(v);
+            if (m_bound == 0 || r <= m_bound)
+            {
+                value = r;
+                break;
+            }
+        }
+    }
+    NS_LOG_DEBUG(values.size() << " values, stream: " << GetStream() << " mean: " << m_mean
+                               << " bound: " << m_bound);
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
 TypeId
@@ -778,6 +835,70 @@ NormalRandomVariable::GetValue()
     return GetValue(m_mean, m_variance, m_bound);
 }
 
+void
+NormalRandomVariable::GetValues(std::span<double> values)
+{
+    // The uniforms come in pairs, each giving two values unless the bound
+    // rejects some: draw in a batch those of the pairs needed at least,
+    // then any more after the batch, as GetValue() would.
+    std::size_t pairs = (values.size() - (m_nextValid ? 1 : 0) + 1) / 2;
+    std::vector<double> uniforms(2 * pairs);
+    Peek()->RandU01(uniforms);
+    std::size_t next = 0;
+    auto uniform = [this, &uniforms, &next]() {
+        return next < uniforms.size() ? uniforms[next++] : Peek()->RandU01();
+    };
+
+    for (double& value : values)
+    {
+        if (m_nextValid)
+        { // use previously generated
+            m_nextValid = false;
+            double x2 = m_mean + m_v2 * m_y * std::sqrt(m_variance);
+            if (std::fabs(x2 - m_mean) <= m_bound)
+            {
+                value = x2;
+                continue;
+            }
+        }
+        while (true)
+        {
+            double u1 = uniform();
+            double u2 = uniform();
+            if (IsAntithetic())
+            {
+                u1 = (1 - u1);
+                u2 = (1 - u2);
+            }
+            double v1 = 2 * u1 - 1;
+            double v2 = 2 * u2 - 1;
+            double w = v1 * v1 + v2 * v2;
+            if (w <= 1.0)
+            {
+                double y = std::sqrt((-2 * std::log(w)) / w);
+                double x1 = m_mean + v1 * y * std::sqrt(m_variance);
+                if (std::fabs(x1 - m_mean) <= m_bound)
+                {
+                    m_nextValid = true;
+                    m_y = y;
+                    m_v2 = v2;
+                    value = x1;
+                    break;
+                }
+                double x2 = m_mean + v2 * y * std::sqrt(m_variance);
+                if (std::fabs(x2 - m_mean) <= m_bound)
+                {
+                    m_nextValid = false;
+                    value = x2;
+                    break;
+                }
+            }
+        }
+    }
+    NS_LOG_DEBUG(values.size() << " values, stream: " << GetStream() << " mean: " << m_mean
+                               << " variance: " << m_variance << " bound: " << m_bound);
+}
+
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
 TypeId
@@ -20,6 +20,7 @@
 #include "type-id.h"
 
 #include <map>
+#include <span>
 #include <stdint.h>
 
 /**
@@ -139,6 +140,17 @@ class RandomVariableStream : public Object
      */
     virtual double GetValue() = 0;
 
+    /**
+     * @brief Fill a span with the next random values drawn from the distribution.
+     *
+     * The values, and the state of the stream afterwards, are the same
+     * as with as many calls to GetValue().  The base implementation
+     * does just that; some distributions draw their uniforms in a batch.
+     *
+     * @param [out] values The values.
+     */
+    virtual void GetValues(std::span<double> values);
+
     /** @copydoc GetValue() */
     // The base implementation returns `(uint32_t)GetValue()`
     virtual uint32_t GetInteger();
@@ -267,6 +279,12 @@ class UniformRandomVariable : public RandomVariableStream
      */
     double GetValue() override;
 
+    /**
+     * @copydoc RandomVariableStream::GetValues()
+     * The uniforms are drawn in a batch, see RngStream::RandU01(std::span<double>).
+     */
+    void GetValues(std::span<double> values) override;
+
     /**
      * @copydoc RandomVariableStream::GetInteger()
      * @note The upper limit is included in the output range, unlike GetValue().
@@ -581,6 +599,12 @@ class ExponentialRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+
+    /**
+     * @copydoc RandomVariableStream::GetValues()
+     * The uniforms are drawn in a batch, see RngStream::RandU01(std::span<double>).
+     */
+    void GetValues(std::span<double> values) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -1019,6 +1043,12 @@ class NormalRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+
+    /**
+     * @copydoc RandomVariableStream::GetValues()
+     * The uniforms are drawn in a batch, see RngStream::RandU01(std::span<double>).
+     */
+    void GetValues(std::span<double> values) override;
     using RandomVariableStream::GetInteger;
 
   private:
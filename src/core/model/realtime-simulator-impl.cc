@@ -17,8 +17,11 @@
 #include "scheduler.h"
 #include "simulator.h"
 #include "synchronizer.h"
+#include "trace-source-accessor.h"
 #include "wall-clock-synchronizer.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <mutex>
 #include <thread>
@@ -53,17 +56,50 @@ RealtimeSimulatorImpl::GetTypeId()
                 EnumValue(SYNC_BEST_EFFORT),
                 MakeEnumAccessor<SynchronizationMode>(
                     &RealtimeSimulatorImpl::SetSynchronizationMode),
-                MakeEnumChecker(SYNC_BEST_EFFORT, "BestEffort", SYNC_HARD_LIMIT, "HardLimit"))
+                MakeEnumChecker(SYNC_BEST_EFFORT,
+                                "BestEffort",
+                                SYNC_HARD_LIMIT,
+                                "HardLimit",
+                                SYNC_CATCH_UP,
+                                "CatchUp"))
             .AddAttribute("HardLimit",
                           "Maximum acceptable real-time jitter (used in conjunction with "
                           "SynchronizationMode=HardLimit)",
                           TimeValue(Seconds(0.1)),
                           MakeTimeAccessor(&RealtimeSimulatorImpl::m_hardLimit),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("CatchUpThreshold",
+                          "Lag from which the overdue events run back to back until the "
+                          "simulation has caught up (used in conjunction with "
+                          "SynchronizationMode=CatchUp)",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&RealtimeSimulatorImpl::m_catchUpThreshold),
+                          MakeTimeChecker(Time(0)))
+            .AddAttribute("Paced",
+                          "Whether the events are paced to real time, or run as fast as "
+                          "possible; see SetPacedWindow() to switch at given times",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&RealtimeSimulatorImpl::SetPaced,
+                                              &RealtimeSimulatorImpl::IsPaced),
+                          MakeBooleanChecker())
+            .AddTraceSource("Lag",
+                            "How late the current event started, behind real time",
+                            MakeTraceSourceAccessor(&RealtimeSimulatorImpl::m_lag),
+                            "ns3::TracedValueCallback::Time")
+            .AddTraceSource("MaxLag",
+                            "The largest lag since Run() was called",
+                            MakeTraceSourceAccessor(&RealtimeSimulatorImpl::m_maxLag),
+                            "ns3::TracedValueCallback::Time")
+            .AddTraceSource("LagHistogram",
+                            "The histogram of the lags since Run() was called, "
+                            "when Run() returns",
+                            MakeTraceSourceAccessor(&RealtimeSimulatorImpl::m_lagHistogramTrace),
+                            "ns3::RealtimeSimulatorImpl::LagHistogramTracedCallback");
     return tid;
 }
 
 RealtimeSimulatorImpl::RealtimeSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY)
 {
     NS_LOG_FUNCTION(this);
 
@@ -75,6 +111,11 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
+    m_paced = true;
+    m_pacing = true;
+    m_catchingUp = false;
+    m_catchUpTs = 0;
+    m_lagHistogram.assign(LAG_HISTOGRAM_BUCKETS, 0);
 
     m_main = std::this_thread::get_id();
 
@@ -92,6 +133,10 @@ void
 RealtimeSimulatorImpl::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    {
+        std::unique_lock lock{m_mutex};
+        ProcessEventsWithContext();
+    }
     while (!m_events->IsEmpty())
     {
         Scheduler::Event next = m_events->RemoveNext();
@@ -146,6 +191,7 @@ RealtimeSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
             }
         }
         m_events = scheduler;
+        ProcessEventsWithContext();
     }
 }
 
@@ -171,6 +217,65 @@ RealtimeSimulatorImpl::ProcessOneEvent()
     // Synchronize() returns true, we will have successfully synchronized the execution
     // time of the next event with the wall clock time of the synchronizer.
     //
+    // In SYNC_CATCH_UP mode, once an event has started too late, there is no point
+    // in synchronizing: the events due by the real time read at the start of the
+    // batch run back to back, without looking at the clock again.  When they are
+    // done, the clock is read once more; we have caught up when the next event is
+    // not due yet.
+    //
+    // While the simulation is not paced (see SetPaced()), the events run one after
+    // the other without looking at the clock at all, as in the DefaultSimulatorImpl.
+    // When pacing resumes, real time restarts from the current event.
+    //
+    bool paced = m_paced;
+    if (paced != m_pacing)
+    {
+        NS_LOG_LOGIC((paced ? "pacing" : "fast-forwarding") << " from " << m_currentTs);
+        m_pacing = paced;
+        m_catchingUp = false;
+        if (paced)
+        {
+            std::unique_lock lock{m_mutex};
+            m_synchronizer->SetOrigin(m_currentTs);
+        }
+    }
+    if (!m_pacing)
+    {
+        Scheduler::Event next;
+        {
+            std::unique_lock lock{m_mutex};
+            ProcessEventsWithContext();
+            next = TakeNextEvent();
+        }
+        next.impl->Invoke();
+        next.impl->Unref();
+        return;
+    }
+
+    if (m_catchingUp)
+    {
+        Scheduler::Event next;
+        {
+            std::unique_lock lock{m_mutex};
+            ProcessEventsWithContext();
+            if (NextTs() > m_catchUpTs)
+            {
+                m_catchUpTs = m_synchronizer->GetCurrentRealtime();
+            }
+            m_catchingUp = NextTs() <= m_catchUpTs;
+            if (m_catchingUp)
+            {
+                next = TakeNextEvent();
+            }
+        }
+        if (m_catchingUp)
+        {
+            RecordLag(m_catchUpTs);
+            next.impl->Invoke();
+            next.impl->Unref();
+            return;
+        }
+    }
 
     for (;;)
     {
@@ -194,6 +299,13 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         {
             std::unique_lock lock{m_mutex};
             //
+            // Reset the synchronizer before looking at the events scheduled
+            // from other threads: an event injected after this point signals
+            // the synchronizer, so that the wait below is interrupted.
+            //
+            m_synchronizer->SetCondition(false);
+            ProcessEventsWithContext();
+            //
             // Since we are in realtime mode, the time to delay has got to be the
             // difference between the current realtime and the timestamp of the next
             // event.  Since m_currentTs is actually the timestamp of the last event we
@@ -239,10 +351,9 @@ RealtimeSimulatorImpl::ProcessOneEvent()
             // We've figured out how long we need to delay in order to pace the
             // simulation time with the real time.  We're going to sleep, but need
             // to work with the synchronizer to make sure we're awakened if something
-            // external happens (like a packet is received).  This next line resets
-            // the synchronizer so that any future event will cause it to interrupt.
+            // external happens (like a packet is received).  The synchronizer was
+            // reset above so that any future event will cause it to interrupt.
             //
-            m_synchronizer->SetCondition(false);
         }
 
         //
@@ -302,6 +413,7 @@ RealtimeSimulatorImpl::ProcessOneEvent()
     // whatever event is at the head of this list if the list is in time order.
     //
     Scheduler::Event next;
+    uint64_t tsFinal;
 
     {
         std::unique_lock lock{m_mutex};
@@ -310,35 +422,11 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         // We do know we're waiting for an event, so there had better be an event on the
         // event queue.  Let's pull it off.  When we release the critical section, the
         // event we're working on won't be on the list and so subsequent operations won't
-        // mess with us.
-        //
-        NS_ASSERT_MSG(m_events->IsEmpty() == false,
-                      "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
-        next = m_events->RemoveNext();
-
-        PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
-
-        m_unscheduledEvents--;
-        m_eventCount++;
-
+        // mess with us.  Events injected from other threads in the meantime
+        // may come first.
         //
-        // We cannot make any assumption that "next" is the same event we originally waited
-        // for.  We can only assume that only that it must be due and cannot cause time
-        // to move backward.
-        //
-        NS_ASSERT_MSG(next.key.m_ts >= m_currentTs,
-                      "RealtimeSimulatorImpl::ProcessOneEvent(): "
-                      "next.GetTs() earlier than m_currentTs (list order error)");
-        NS_LOG_LOGIC("handle " << next.key.m_ts);
-
-        //
-        // Update the current simulation time to be the timestamp of the event we're
-        // executing.  From the rest of the simulation's point of view, simulation time
-        // is frozen until the next event is executed.
-        //
-        m_currentTs = next.key.m_ts;
-        m_currentContext = next.key.m_context;
-        m_currentUid = next.key.m_uid;
+        ProcessEventsWithContext();
+        next = TakeNextEvent();
 
         //
         // We're about to run the event and we've done our best to synchronize this
@@ -347,11 +435,11 @@ RealtimeSimulatorImpl::ProcessOneEvent()
         // been asked to commit ritual suicide.
         //
         // We check the simulation time against the current real time to make this
-        // judgement.
+        // judgement.  The same time gives the lag statistics.
         //
+        tsFinal = m_synchronizer->GetCurrentRealtime();
         if (m_synchronizationMode == SYNC_HARD_LIMIT)
         {
-            uint64_t tsFinal = m_synchronizer->GetCurrentRealtime();
             uint64_t tsJitter;
 
             if (tsFinal >= m_currentTs)
@@ -377,6 +465,7 @@ RealtimeSimulatorImpl::ProcessOneEvent()
     // event list so we can execute it outside a critical section without fear of someone
     // changing things out from under us.
 
+    RecordLag(tsFinal);
     EventImpl* event = next.impl;
     m_synchronizer->EventStart();
     event->Invoke();
@@ -384,13 +473,66 @@ RealtimeSimulatorImpl::ProcessOneEvent()
     event->Unref();
 }
 
+Scheduler::Event
+RealtimeSimulatorImpl::TakeNextEvent()
+{
+    NS_ASSERT_MSG(m_events->IsEmpty() == false,
+                  "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
+    Scheduler::Event next = m_events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    m_unscheduledEvents--;
+    m_eventCount++;
+
+    //
+    // We cannot make any assumption that "next" is the same event we originally waited
+    // for.  We can only assume that only that it must be due and cannot cause time
+    // to move backward.
+    //
+    NS_ASSERT_MSG(next.key.m_ts >= m_currentTs,
+                  "RealtimeSimulatorImpl::ProcessOneEvent(): "
+                  "next.GetTs() earlier than m_currentTs (list order error)");
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+
+    //
+    // Update the current simulation time to be the timestamp of the event we're
+    // executing.  From the rest of the simulation's point of view, simulation time
+    // is frozen until the next event is executed.
+    //
+    m_currentTs = next.key.m_ts;
+    m_currentContext = next.key.m_context;
+    m_currentUid = next.key.m_uid;
+    return next;
+}
+
+void
+RealtimeSimulatorImpl::RecordLag(uint64_t tsNow)
+{
+    Time lag = TimeStep(tsNow > m_currentTs ? tsNow - m_currentTs : 0);
+    m_lag = lag;
+    if (lag > m_maxLag)
+    {
+        m_maxLag = lag;
+    }
+    auto us = static_cast<uint64_t>(lag.GetMicroSeconds());
+    m_lagHistogram[std::min<uint64_t>(std::bit_width(us), LAG_HISTOGRAM_BUCKETS - 1)]++;
+
+    if (m_synchronizationMode == SYNC_CATCH_UP && !m_catchingUp && lag > m_catchUpThreshold)
+    {
+        NS_LOG_LOGIC("catching up from " << lag);
+        m_catchingUp = true;
+        m_catchUpTs = tsNow;
+    }
+}
+
 bool
 RealtimeSimulatorImpl::IsFinished() const
 {
     bool rc;
     {
         std::unique_lock lock{m_mutex};
-        rc = m_events->IsEmpty() || m_stop;
+        rc = (m_events->IsEmpty() && m_eventsWithContext.IsEmpty()) || m_stop;
     }
 
     return rc;
@@ -421,6 +563,11 @@ RealtimeSimulatorImpl::Run()
     m_stop = false;
     m_running = true;
     m_synchronizer->SetOrigin(m_currentTs);
+    m_pacing = m_paced;
+    m_catchingUp = false;
+    m_lag = Time(0);
+    m_maxLag = Time(0);
+    m_lagHistogram.assign(LAG_HISTOGRAM_BUCKETS, 0);
 
     // Sleep until signalled
     uint64_t tsNow = 0;
@@ -432,6 +579,7 @@ RealtimeSimulatorImpl::Run()
         {
             std::unique_lock lock{m_mutex};
 
+            ProcessEventsWithContext();
             if (!m_events->IsEmpty())
             {
                 process = true;
@@ -466,6 +614,7 @@ RealtimeSimulatorImpl::Run()
     }
 
     m_running = false;
+    m_lagHistogramTrace(m_lagHistogram);
 }
 
 bool
@@ -531,23 +680,22 @@ RealtimeSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay,
 {
     NS_LOG_FUNCTION(this << context << delay << impl);
 
+    if (m_main != std::this_thread::get_id())
     {
-        std::unique_lock lock{m_mutex};
-        uint64_t ts;
+        //
+        // If the simulator is running, we're pacing and have a meaningful
+        // realtime clock.  If we're not, then the event is relative to
+        // m_currentTs, where we stopped.
+        //
+        bool running = m_running;
+        uint64_t ts = running ? m_synchronizer->GetCurrentRealtime() : 0;
+        InjectEvent(context, ts + delay.GetTimeStep(), running, impl);
+        return;
+    }
 
-        if (m_main == std::this_thread::get_id())
-        {
-            ts = m_currentTs + delay.GetTimeStep();
-        }
-        else
-        {
-            //
-            // If the simulator is running, we're pacing and have a meaningful
-            // realtime clock.  If we're not, then m_currentTs is where we stopped.
-            //
-            ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
-            ts += delay.GetTimeStep();
-        }
+    {
+        std::unique_lock lock{m_mutex};
+        uint64_t ts = m_currentTs + delay.GetTimeStep();
 
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
@@ -586,15 +734,27 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext(uint32_t context,
 {
     NS_LOG_FUNCTION(this << context << time << impl);
 
+    if (m_main != std::this_thread::get_id())
+    {
+        InjectEvent(context,
+                    m_synchronizer->GetCurrentRealtime() + time.GetTimeStep(),
+                    true,
+                    impl);
+        return;
+    }
+
     {
         std::unique_lock lock{m_mutex};
 
-        uint64_t ts = m_synchronizer->GetCurrentRealtime() + time.GetTimeStep();
+        // while fast-forwarding, real time is behind: use the current time
+        uint64_t now = m_pacing ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        uint64_t ts = now + time.GetTimeStep();
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
         Scheduler::Event ev;
         ev.impl = impl;
         ev.key.m_ts = ts;
+        ev.key.m_context = context;
         ev.key.m_uid = m_uid;
         m_uid++;
         m_unscheduledEvents++;
@@ -603,6 +763,53 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext(uint32_t context,
     }
 }
 
+void
+RealtimeSimulatorImpl::InjectEvent(uint32_t context,
+                                   uint64_t timestamp,
+                                   bool realtime,
+                                   EventImpl* impl)
+{
+    NS_LOG_FUNCTION(this << context << timestamp << realtime << impl);
+
+    EventWithContext ev{context, timestamp, realtime, impl};
+    if (!m_eventsWithContext.Push(ev))
+    {
+        //
+        // The queue is full.  Drain it into the event list ourselves, so that
+        // the event still comes after those scheduled before it.
+        //
+        std::unique_lock lock{m_mutex};
+        do
+        {
+            ProcessEventsWithContext();
+        } while (!m_eventsWithContext.Push(ev));
+    }
+    m_synchronizer->Signal();
+}
+
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext()
+{
+    EventWithContext event;
+    while (m_eventsWithContext.Pop(event))
+    {
+        //
+        // Real time may have moved past the time stamp of an event injected
+        // while the main thread was executing a later event: run it now.
+        //
+        uint64_t ts = event.realtime ? std::max(event.timestamp, m_currentTs)
+                                     : m_currentTs + event.timestamp;
+        Scheduler::Event ev;
+        ev.impl = event.event;
+        ev.key.m_ts = ts;
+        ev.key.m_context = event.context;
+        ev.key.m_uid = m_uid;
+        m_uid++;
+        m_unscheduledEvents++;
+        m_events->Insert(ev);
+    }
+}
+
 void
 RealtimeSimulatorImpl::ScheduleRealtime(const Time& time, EventImpl* impl)
 {
@@ -614,6 +821,14 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(uint32_t context, EventImpl* impl)
 {
     NS_LOG_FUNCTION(this << context << impl);
+
+    if (m_main != std::this_thread::get_id())
+    {
+        bool running = m_running;
+        InjectEvent(context, running ? m_synchronizer->GetCurrentRealtime() : 0, running, impl);
+        return;
+    }
+
     {
         std::unique_lock lock{m_mutex};
 
@@ -621,7 +836,7 @@ RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(uint32_t context, EventImp
         // If the simulator is running, we're pacing and have a meaningful
         // realtime clock.  If we're not, then m_currentTs is were we stopped.
         //
-        uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
+        uint64_t ts = m_running && m_pacing ? m_synchronizer->GetCurrentRealtime() : m_currentTs;
         NS_ASSERT_MSG(ts >= m_currentTs,
                       "RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(): schedule for time "
                       "< m_currentTs");
@@ -819,4 +1034,71 @@ RealtimeSimulatorImpl::GetHardLimit() const
     return m_hardLimit;
 }
 
+void
+RealtimeSimulatorImpl::SetCatchUpThreshold(Time threshold)
+{
+    NS_LOG_FUNCTION(this << threshold);
+    m_catchUpThreshold = threshold;
+}
+
+Time
+RealtimeSimulatorImpl::GetCatchUpThreshold() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_catchUpThreshold;
+}
+
+Time
+RealtimeSimulatorImpl::GetLag() const
+{
+    return m_lag;
+}
+
+Time
+RealtimeSimulatorImpl::GetMaxLag() const
+{
+    return m_maxLag;
+}
+
+std::vector<uint64_t>
+RealtimeSimulatorImpl::GetLagHistogram() const
+{
+    return m_lagHistogram;
+}
+
+void
+RealtimeSimulatorImpl::SetPaced(bool paced)
+{
+    NS_LOG_FUNCTION(this << paced);
+    m_paced = paced;
+    if (m_synchronizer)
+    {
+        // wake up the main thread, if it is waiting for the next event
+        m_synchronizer->Signal();
+    }
+}
+
+bool
+RealtimeSimulatorImpl::IsPaced() const
+{
+    return m_paced;
+}
+
+void
+RealtimeSimulatorImpl::SetPacedWindow(const Time& start, const Time& stop)
+{
+    NS_LOG_FUNCTION(this << start << stop);
+    NS_ASSERT_MSG(start <= stop, "RealtimeSimulatorImpl::SetPacedWindow(): start after stop");
+    Time now = Now();
+    SetPaced(start <= now && now < stop);
+    if (start > now)
+    {
+        Simulator::Schedule(start - now, &RealtimeSimulatorImpl::SetPaced, this, true);
+    }
+    if (stop > now)
+    {
+        Simulator::Schedule(stop - now, &RealtimeSimulatorImpl::SetPaced, this, false);
+    }
+}
+
 } // namespace ns3
@@ -10,14 +10,19 @@
 #include "assert.h"
 #include "event-impl.h"
 #include "log.h"
+#include "mpsc-queue.h"
 #include "ptr.h"
 #include "scheduler.h"
 #include "simulator-impl.h"
 #include "synchronizer.h"
+#include "traced-callback.h"
+#include "traced-value.h"
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 /**
  * @file
@@ -69,8 +74,29 @@ class RealtimeSimulatorImpl : public SimulatorImpl
          * @see SetHardLimit
          */
         SYNC_HARD_LIMIT,
+        /**
+         * Make a best effort to keep synced to real-time, and catch up
+         * quickly after falling behind.
+         *
+         * Once an event runs more than the catch-up threshold late, the
+         * overdue events run back to back, reading the real time clock
+         * once per batch instead of synchronizing each event, until the
+         * simulation has caught up.
+         * @see SetCatchUpThreshold
+         */
+        SYNC_CATCH_UP,
     };
 
+    /** Number of buckets of the lag histogram. */
+    static constexpr uint32_t LAG_HISTOGRAM_BUCKETS = 32;
+
+    /**
+     * TracedCallback signature for the lag histogram.
+     *
+     * @param [in] histogram The number of events in each bucket.
+     */
+    typedef void (*LagHistogramTracedCallback)(const std::vector<uint64_t>& histogram);
+
     /** Constructor. */
     RealtimeSimulatorImpl();
     /** Destructor. */
@@ -152,6 +178,76 @@ class RealtimeSimulatorImpl : public SimulatorImpl
      */
     Time GetHardLimit() const;
 
+    /**
+     * Switch between real time pacing and running the events as fast as
+     * possible.
+     *
+     * While the simulation is not paced, it runs like the
+     * DefaultSimulatorImpl: events do not wait for real time, and events
+     * scheduled in real time, from this thread or from others, are due
+     * at the current simulation time.  When pacing resumes, real time
+     * restarts from the current simulation time.
+     *
+     * This can be called from any thread, and from an event, see
+     * SetPacedWindow().
+     *
+     * @param [in] paced Whether to pace the events.
+     */
+    void SetPaced(bool paced);
+    /**
+     * Get whether the events are paced to real time.
+     *
+     * @returns \c true if the events are paced.
+     */
+    bool IsPaced() const;
+    /**
+     * Schedule the simulation to be paced to real time only from
+     * \p start to \p stop, and to run as fast as possible before and
+     * after.
+     *
+     * @param [in] start The simulation time at which pacing starts.
+     * @param [in] stop The simulation time at which pacing stops.
+     */
+    void SetPacedWindow(const Time& start, const Time& stop);
+
+    /**
+     * Set the lag from which SynchronizationMode SYNC_CATCH_UP runs the
+     * overdue events back to back.
+     *
+     * @param [in] threshold The catch-up threshold.
+     */
+    void SetCatchUpThreshold(Time threshold);
+    /**
+     * Get the catch-up threshold of SynchronizationMode SYNC_CATCH_UP.
+     *
+     * @returns The catch-up threshold.
+     */
+    Time GetCatchUpThreshold() const;
+
+    /**
+     * Get how late the last event started, behind real time.
+     *
+     * @returns The current lag.
+     */
+    Time GetLag() const;
+    /**
+     * Get the largest lag since Run() was called.
+     *
+     * @returns The maximum lag.
+     */
+    Time GetMaxLag() const;
+    /**
+     * Get the histogram of the lags of the events since Run() was called.
+     *
+     * Bucket 0 counts the events less than 1 us late, bucket \c i the
+     * events between 2^(i-1) and 2^i us late, and the last bucket all the
+     * later ones.
+     *
+     * @returns The number of events in each of the LAG_HISTOGRAM_BUCKETS
+     *          buckets.
+     */
+    std::vector<uint64_t> GetLagHistogram() const;
+
   private:
     /**
      * Is the simulator running?
@@ -170,8 +266,61 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     uint64_t NextTs() const;
     /** Process the next event. */
     void ProcessOneEvent();
+    /**
+     * Remove the next event from the event list and make it the current
+     * event.  Must be called with #m_mutex locked.
+     *
+     * @returns The event.
+     */
+    Scheduler::Event TakeNextEvent();
+    /**
+     * Update the lag statistics when an event starts, and decide whether
+     * to catch up.
+     *
+     * @param [in] tsNow The real time at which the current event starts.
+     */
+    void RecordLag(uint64_t tsNow);
     /** Destructor implementation. */
     void DoDispose() override;
+    /**
+     * Schedule an event from a thread other than the main one.
+     *
+     * The event is handed over through #m_eventsWithContext, without
+     * taking #m_mutex unless the queue is full.
+     *
+     * @param [in] context The event context.
+     * @param [in] timestamp The event time stamp, absolute if \p realtime,
+     *             else relative to the time of the current event.
+     * @param [in] realtime Whether \p timestamp is absolute.
+     * @param [in] impl The event implementation.
+     */
+    void InjectEvent(uint32_t context, uint64_t timestamp, bool realtime, EventImpl* impl);
+    /**
+     * Move the events scheduled from other threads into the event list.
+     * Must be called with #m_mutex locked.
+     */
+    void ProcessEventsWithContext();
+
+    /** Wrap an event scheduled from another thread. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event time stamp. */
+        uint64_t timestamp;
+        /** Whether the time stamp is absolute, or relative to the current event. */
+        bool realtime;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /** Capacity of the queue of events from other threads. */
+    static constexpr uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 4096;
+    /**
+     * The events scheduled from other threads.  Any thread holding
+     * #m_mutex may consume it.
+     */
+    MpscQueue<EventWithContext> m_eventsWithContext;
 
     /** Container type for events to be run at destroy time. */
     typedef std::list<EventId> DestroyEvents;
@@ -180,7 +329,7 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** Has the stopping condition been reached? */
     bool m_stop;
     /** Is the simulator currently running. */
-    bool m_running;
+    std::atomic<bool> m_running;
 
     /**
      * @name Mutex-protected variables.
@@ -216,6 +365,26 @@ class RealtimeSimulatorImpl : public SimulatorImpl
     /** The maximum allowable drift from real-time in SYNC_HARD_LIMIT mode. */
     Time m_hardLimit;
 
+    /** The lag from which SYNC_CATCH_UP mode runs the overdue events back to back. */
+    Time m_catchUpThreshold;
+    /** Whether the events are to be paced, as set by SetPaced(). */
+    std::atomic<bool> m_paced;
+    /** Whether the main thread paces the events. */
+    bool m_pacing;
+    /** Whether the overdue events run back to back. */
+    bool m_catchingUp;
+    /** The real time read at the start of the current catch-up batch. */
+    uint64_t m_catchUpTs;
+
+    /** How late the current event started, behind real time. */
+    TracedValue<Time> m_lag;
+    /** The largest lag since Run() was called. */
+    TracedValue<Time> m_maxLag;
+    /** The histogram of the lags since Run() was called. */
+    std::vector<uint64_t> m_lagHistogram;
+    /** Trace of the lag histogram, when Run() returns. */
+    TracedCallback<const std::vector<uint64_t>&> m_lagHistogramTrace;
+
     /** Main thread. */
     std::thread::id m_main;
 };
@@ -7,6 +7,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <span>
 #include <stdint.h>
 #include <string>
 
@@ -60,6 +61,19 @@ class RngStream
      */
     double RandU01();
 
+    /**
+     * Generate the next random numbers for this stream, as many calls
+     * to RandU01() would, bit for bit, and leave the stream in the same
+     * state.
+     *
+     * Large batches are cut in chunks generated side by side, each from
+     * the state jumped ahead to its start, so the compiler can vectorise
+     * the recurrence across them.
+     *
+     * @param [out] u The next randoms.
+     */
+    void RandU01(std::span<double> u);
+
   private:
     /**
      * Advance \pname{state} of the RNG by leaps and bounds.
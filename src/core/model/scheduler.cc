@@ -36,4 +36,15 @@ Scheduler::GetTypeId()
     return tid;
 }
 
+void
+Scheduler::RemoveNextBatch(std::vector<Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    uint64_t ts = PeekNext().key.m_ts;
+    do
+    {
+        events.push_back(RemoveNext());
+    } while (!IsEmpty() && PeekNext().key.m_ts == ts);
+}
+
 } // namespace ns3
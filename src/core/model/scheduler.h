@@ -12,6 +12,7 @@
 #include "object.h"
 
 #include <stdint.h>
+#include <vector>
 
 /**
  * @file
@@ -215,6 +216,19 @@ class Scheduler : public Object
      * @param [in] ev The event to remove
      */
     virtual void Remove(const Event& ev) = 0;
+    /**
+     * Remove all the events with the earliest time stamp.
+     *
+     * The events are appended to \p events in increasing EventKey order,
+     * the order in which RemoveNext() would return them.  The default
+     * implementation calls RemoveNext() until the time stamp changes;
+     * schedulers which keep these events together can do better.
+     *
+     * This method cannot be invoked if the list is empty.
+     *
+     * @param [in,out] events The vector to append the events to.
+     */
+    virtual void RemoveNextBatch(std::vector<Event>& events);
 };
 
 /**
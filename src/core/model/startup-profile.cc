@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "startup-profile.h"
+
+#include <array>
+#include <iomanip>
+#include <string>
+
+#ifdef __linux__
+#include <fstream>
+#include <sstream>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file
+ * @ingroup core
+ * ns3::StartupProfile implementation.
+ */
+
+namespace ns3
+{
+
+namespace
+{
+
+/** The totals of a phase. */
+struct PhaseTotal
+{
+    uint32_t count;    //!< The number of timers.
+    uint32_t depth;    //!< The number of timers running.
+    int64_t ns;        //!< The time of the outermost timers, in ns.
+    const char* label; //!< The label of the phase.
+};
+
+/**
+ * The totals of the phases.
+ *
+ * This is constant initialized, so it can be used by the static
+ * initialisation of any library.
+ */
+std::array<PhaseTotal, StartupProfile::PHASE_N> g_totals{{
+    {0, 0, 0, "LogComponent construction"},
+    {0, 0, 0, "GlobalValue construction"},
+    {0, 0, 0, "TypeId registration deferral"},
+    {0, 0, 0, "TypeId registration"},
+}};
+
+/**
+ * Get the start time of the first timer.
+ *
+ * @returns The start time.
+ */
+std::chrono::steady_clock::time_point
+GetOrigin()
+{
+    static std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return origin;
+}
+
+/**
+ * Get the time elapsed since the start of the process, where known.
+ *
+ * @returns The time, in ns, or -1 if unknown.
+ */
+int64_t
+GetProcessTime()
+{
+#ifdef __linux__
+    // The start time, in clock ticks since boot, is the 22nd field of
+    // the stat, counting from the command name which may contain spaces
+    std::ifstream stat("/proc/self/stat");
+    std::string line;
+    if (!std::getline(stat, line))
+    {
+        return -1;
+    }
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    for (int i = 3; i < 22; ++i)
+    {
+        fields >> field;
+    }
+    unsigned long long ticks = 0;
+    fields >> ticks;
+    timespec now;
+    if (!fields || clock_gettime(CLOCK_BOOTTIME, &now) != 0)
+    {
+        return -1;
+    }
+    int64_t start = static_cast<int64_t>(ticks) * 1000000000 / sysconf(_SC_CLK_TCK);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec - start;
+#else
+    return -1;
+#endif
+}
+
+} // unnamed namespace
+
+StartupProfile::Timer::Timer(Phase phase)
+    : m_phase(phase),
+      m_start(std::chrono::steady_clock::now())
+{
+    GetOrigin();
+    g_totals[m_phase].count++;
+    g_totals[m_phase].depth++;
+}
+
+StartupProfile::Timer::~Timer()
+{
+    // nested timers of the same phase are already counted by the outermost
+    if (--g_totals[m_phase].depth == 0)
+    {
+        g_totals[m_phase].ns +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                 m_start)
+                .count();
+    }
+}
+
+void
+StartupProfile::Print(std::ostream& os)
+{
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - GetOrigin())
+                          .count();
+    int64_t process = GetProcessTime();
+    int64_t timed = 0;
+    for (const auto& total : g_totals)
+    {
+        timed += total.ns;
+    }
+
+    auto line = [&os](const std::string& label, int64_t ns, const std::string& note) {
+        os << "  " << std::left << std::setw(48) << label + ":" << std::right << std::fixed
+           << std::setprecision(3) << std::setw(10) << ns / 1e6 << " ms" << note << "\n";
+    };
+
+    os << "Startup profile:\n";
+    if (process >= 0)
+    {
+        line("Process start to CommandLine", process, " (+/- 1 clock tick)");
+        line("  Process start to first registration", process - elapsed, ", loading mostly");
+    }
+    line("First registration to CommandLine", elapsed, "");
+    for (const auto& total : g_totals)
+    {
+        line("  " + std::string(total.label), total.ns, ", " + std::to_string(total.count));
+    }
+    line("  Other static initialisation and main", elapsed - timed, "");
+    os << std::flush;
+}
+
+} // namespace ns3
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+/**
+ * @file
+ * @ingroup core
+ * ns3::StartupProfile declaration.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace ns3
+{
+
+/**
+ * @ingroup core
+ *
+ * Where the time goes at process startup, before \c main gets going.
+ *
+ * The static initialisation of the ns-3 libraries registers LogComponents,
+ * GlobalValues and TypeIds.  Each of these registrations is timed with a
+ * StartupProfile::Timer, and the totals are printed by
+ * \c \--PrintStartupProfile (or \c \--startup-profile) on the command line
+ * of any program parsing its arguments with CommandLine.
+ *
+ * The registration of the TypeIds is deferred until they are looked up
+ * (see NS_OBJECT_ENSURE_REGISTERED()), so the profile shows how many
+ * TypeIds were deferred at startup, and the time spent registering those
+ * looked up since.
+ */
+class StartupProfile
+{
+  public:
+    /** The timed phases of the startup. */
+    enum Phase
+    {
+        LOG_COMPONENT = 0, //!< Construction of the LogComponents.
+        GLOBAL_VALUE,      //!< Construction of the GlobalValues.
+        TYPE_ID_DEFERRAL,  //!< Deferral of the TypeId registrations.
+        TYPE_ID,           //!< Registration of the deferred TypeIds.
+        PHASE_N            //!< The number of phases.
+    };
+
+    /** Time a phase from construction to destruction. */
+    class Timer
+    {
+      public:
+        /**
+         * Constructor.
+         *
+         * @param [in] phase The phase timed.
+         */
+        Timer(Phase phase);
+        /** Destructor: add the time elapsed to the phase. */
+        ~Timer();
+
+      private:
+        Phase m_phase;                                 //!< The phase timed.
+        std::chrono::steady_clock::time_point m_start; //!< The start time.
+    };
+
+    /**
+     * Print the profile.
+     *
+     * @param [in,out] os The output stream.
+     */
+    static void Print(std::ostream& os);
+};
+
+} // namespace ns3
+
+#endif /* STARTUP_PROFILE_H */
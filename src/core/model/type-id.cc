@@ -10,11 +10,14 @@
 #include "hash.h"
 #include "log.h" // NS_ASSERT and NS_LOG
 #include "singleton.h"
+#include "startup-profile.h"
 #include "trace-source-accessor.h"
 
+#include <algorithm>
 #include <iomanip>
-#include <map>
 #include <sstream>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -121,6 +124,19 @@ class IidManager : public Singleton<IidManager>
      * @returns The type id.  A type id of 0 means \pname{hash} wasn't found.
      */
     uint16_t GetUid(TypeId::hash_t hash) const;
+    /**
+     * Defer the registration of a type id until it is looked up.
+     * @param [in] name The name of the class, without namespace.
+     * @param [in] registration The function registering the type id.
+     */
+    void Defer(const char* name, void (*registration)());
+    /**
+     * Register the deferred type ids of the classes with a name.
+     * @param [in] name The name of the class, without namespace.
+     */
+    void RegisterDeferred(std::string_view name);
+    /** Register all the deferred type ids. */
+    void RegisterDeferred();
     /**
      * Get the name of a type id.
      * @param [in] uid The id.
@@ -271,6 +287,22 @@ class IidManager : public Singleton<IidManager>
      * @returns \c true if this TypeId should be hidden from the user.
      */
     bool MustHideFromDocumentation(uint16_t uid) const;
+    /**
+     * Find an Attribute by name, in a type id or its parents.
+     * @param [in] uid The id.
+     * @param [in] name The Attribute name.
+     * @returns The id declaring the Attribute and the index of the
+     *          Attribute there; an id of 0 means \pname{name} wasn't found.
+     */
+    std::pair<uint16_t, std::size_t> FindAttribute(uint16_t uid, const std::string& name) const;
+    /**
+     * Find a TraceSource by name, in a type id or its parents.
+     * @param [in] uid The id.
+     * @param [in] name The TraceSource name.
+     * @returns The id declaring the TraceSource and the index of the
+     *          TraceSource there; an id of 0 means \pname{name} wasn't found.
+     */
+    std::pair<uint16_t, std::size_t> FindTraceSource(uint16_t uid, const std::string& name) const;
 
   private:
     /**
@@ -294,6 +326,30 @@ class IidManager : public Singleton<IidManager>
      */
     static TypeId::hash_t Hasher(const std::string name);
 
+    /**
+     * Type of the by-name indices of the Attributes and TraceSources of a
+     * type id, inherited ones included: the id declaring the entry, and
+     * the index of the entry there.
+     */
+    typedef std::unordered_map<std::string, std::pair<uint16_t, std::size_t>> index_t;
+    /**
+     * Add an entry to the by-name index of a type id, and to those of its
+     * children, unless one of their own entries has the same name.
+     * @param [in] uid The id.
+     * @param [in] attribute \c true for an Attribute, \c false for a TraceSource.
+     * @param [in] name The name of the entry.
+     * @param [in] entry The id declaring the entry and its index there.
+     */
+    void AddToIndex(uint16_t uid,
+                    bool attribute,
+                    const std::string& name,
+                    std::pair<uint16_t, std::size_t> entry);
+    /**
+     * Rebuild the by-name indices of a type id, and those of its children.
+     * @param [in] uid The id.
+     */
+    void RebuildIndices(uint16_t uid);
+
     /** The information record about a single type id. */
     struct IidInformation
     {
@@ -323,6 +379,12 @@ class IidManager : public Singleton<IidManager>
         TypeId::SupportLevel supportLevel;
         /** Support message. */
         std::string supportMsg;
+        /** The Attributes by name, inherited ones included. */
+        index_t attributeIndex;
+        /** The TraceSources by name, inherited ones included. */
+        index_t traceSourceIndex;
+        /** The type ids which have this one as parent. */
+        std::vector<uint16_t> children;
     };
 
     /** Iterator type. */
@@ -339,15 +401,20 @@ class IidManager : public Singleton<IidManager>
     std::vector<IidInformation> m_information;
 
     /** Type of the by-name index. */
-    typedef std::map<std::string, uint16_t> namemap_t;
+    typedef std::unordered_map<std::string, uint16_t> namemap_t;
     /** The by-name index. */
     namemap_t m_namemap;
 
     /** Type of the by-hash index. */
-    typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+    typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** Type of the deferred registrations, by class name. */
+    typedef std::unordered_multimap<std::string_view, void (*)()> deferredmap_t;
+    /** The deferred registrations. */
+    deferredmap_t m_deferred;
+
     /** IidManager constants. */
     enum
     {
@@ -486,7 +553,69 @@ IidManager::SetParent(uint16_t uid, uint16_t parent)
     NS_LOG_FUNCTION(IID << uid << parent);
     NS_ASSERT(parent <= m_information.size());
     IidInformation* information = LookupInformation(uid);
+    if (information->parent != 0 && information->parent != uid)
+    {
+        auto& siblings = LookupInformation(information->parent)->children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), uid));
+    }
     information->parent = parent;
+    if (parent != 0 && parent != uid)
+    {
+        LookupInformation(parent)->children.push_back(uid);
+    }
+    RebuildIndices(uid);
+}
+
+void
+IidManager::AddToIndex(uint16_t uid,
+                       bool attribute,
+                       const std::string& name,
+                       std::pair<uint16_t, std::size_t> entry)
+{
+    NS_LOG_FUNCTION(IID << uid << attribute << name << entry.first << entry.second);
+    IidInformation* information = LookupInformation(uid);
+    index_t& index = attribute ? information->attributeIndex : information->traceSourceIndex;
+    if (entry.first != uid && index.count(name) != 0)
+    {
+        // a closer entry hides this one, here and in the children
+        return;
+    }
+    index[name] = entry;
+    for (uint16_t child : information->children)
+    {
+        AddToIndex(child, attribute, name, entry);
+    }
+}
+
+void
+IidManager::RebuildIndices(uint16_t uid)
+{
+    NS_LOG_FUNCTION(IID << uid);
+    IidInformation* information = LookupInformation(uid);
+    information->attributeIndex.clear();
+    information->traceSourceIndex.clear();
+    for (std::size_t i = 0; i < information->attributes.size(); ++i)
+    {
+        information->attributeIndex.emplace(information->attributes[i].name, std::pair{uid, i});
+    }
+    for (std::size_t i = 0; i < information->traceSources.size(); ++i)
+    {
+        information->traceSourceIndex.emplace(information->traceSources[i].name,
+                                              std::pair{uid, i});
+    }
+    if (information->parent != 0 && information->parent != uid)
+    {
+        // the own entries hide the inherited ones
+        const IidInformation* parent = LookupInformation(information->parent);
+        information->attributeIndex.insert(parent->attributeIndex.begin(),
+                                           parent->attributeIndex.end());
+        information->traceSourceIndex.insert(parent->traceSourceIndex.begin(),
+                                             parent->traceSourceIndex.end());
+    }
+    for (uint16_t child : information->children)
+    {
+        RebuildIndices(child);
+    }
 }
 
 void
@@ -540,6 +669,45 @@ IidManager::GetUid(std::string name) const
     return uid;
 }
 
+void
+IidManager::Defer(const char* name, void (*registration)())
+{
+    NS_LOG_FUNCTION(IID << name);
+    m_deferred.emplace(name, registration);
+}
+
+void
+IidManager::RegisterDeferred(std::string_view name)
+{
+    NS_LOG_FUNCTION(IID << name);
+    auto [first, last] = m_deferred.equal_range(name);
+    // the registrations may look up, and so register, other type ids
+    std::vector<void (*)()> registrations;
+    for (auto it = first; it != last; ++it)
+    {
+        registrations.push_back(it->second);
+    }
+    m_deferred.erase(first, last);
+    for (auto registration : registrations)
+    {
+        StartupProfile::Timer timer(StartupProfile::TYPE_ID);
+        registration();
+    }
+}
+
+void
+IidManager::RegisterDeferred()
+{
+    NS_LOG_FUNCTION(IID << m_deferred.size());
+    while (!m_deferred.empty())
+    {
+        auto registration = m_deferred.begin()->second;
+        m_deferred.erase(m_deferred.begin());
+        StartupProfile::Timer timer(StartupProfile::TYPE_ID);
+        registration();
+    }
+}
+
 uint16_t
 IidManager::GetUid(TypeId::hash_t hash) const
 {
@@ -652,29 +820,9 @@ bool
 IidManager::HasAttribute(uint16_t uid, std::string name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    IidInformation* information = LookupInformation(uid);
-    while (true)
-    {
-        for (auto i = information->attributes.begin(); i != information->attributes.end(); ++i)
-        {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
-        }
-        IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
-        {
-            // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
-        }
-        // check parent
-        information = parent;
-    }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
+    bool has = FindAttribute(uid, name).first != 0;
+    NS_LOG_LOGIC(IIDL << has);
+    return has;
 }
 
 void
@@ -713,6 +861,7 @@ IidManager::AddAttribute(uint16_t uid,
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
     information->attributes.push_back(info);
+    AddToIndex(uid, true, name, {uid, information->attributes.size() - 1});
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -751,29 +900,9 @@ bool
 IidManager::HasTraceSource(uint16_t uid, std::string name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    IidInformation* information = LookupInformation(uid);
-    while (true)
-    {
-        for (auto i = information->traceSources.begin(); i != information->traceSources.end(); ++i)
-        {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
-        }
-        IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
-        {
-            // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
-        }
-        // check parent
-        information = parent;
-    }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
+    bool has = FindTraceSource(uid, name).first != 0;
+    NS_LOG_LOGIC(IIDL << has);
+    return has;
 }
 
 void
@@ -801,6 +930,7 @@ IidManager::AddTraceSource(uint16_t uid,
     source.supportLevel = supportLevel;
     source.supportMsg = supportMsg;
     information->traceSources.push_back(source);
+    AddToIndex(uid, false, name, {uid, information->traceSources.size() - 1});
     NS_LOG_LOGIC(IIDL << information->traceSources.size() - 1);
 }
 
@@ -824,6 +954,32 @@ IidManager::GetTraceSource(uint16_t uid, std::size_t i) const
     return information->traceSources[i];
 }
 
+std::pair<uint16_t, std::size_t>
+IidManager::FindAttribute(uint16_t uid, const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    const index_t& index = LookupInformation(uid)->attributeIndex;
+    auto it = index.find(name);
+    if (it == index.end())
+    {
+        return {0, 0};
+    }
+    return it->second;
+}
+
+std::pair<uint16_t, std::size_t>
+IidManager::FindTraceSource(uint16_t uid, const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    const index_t& index = LookupInformation(uid)->traceSourceIndex;
+    auto it = index.find(name);
+    if (it == index.end())
+    {
+        return {0, 0};
+    }
+    return it->second;
+}
+
 bool
 IidManager::MustHideFromDocumentation(uint16_t uid) const
 {
@@ -868,11 +1024,43 @@ TypeId::AddDeprecatedName(const std::string& name)
     return *this;
 }
 
+/**
+ * @ingroup object
+ * @internal
+ * Get a type id by name, registering the deferred type ids which may
+ * have that name if it isn't registered yet.
+ * @param [in] name The type id to find.
+ * @returns The type id.  A type id of 0 means \pname{name} wasn't found.
+ */
+static uint16_t
+GetUidRegistering(const std::string& name)
+{
+    IidManager* manager = IidManager::Get();
+    uint16_t uid = manager->GetUid(name);
+    if (uid == 0)
+    {
+        // first the classes named like the last part of the name,
+        // before any template arguments
+        std::string_view className(name);
+        className = className.substr(0, className.find('<'));
+        std::size_t scope = className.rfind("::");
+        className = std::string_view(name).substr(scope == std::string_view::npos ? 0 : scope + 2);
+        manager->RegisterDeferred(className);
+        uid = manager->GetUid(name);
+    }
+    if (uid == 0)
+    {
+        manager->RegisterDeferred();
+        uid = manager->GetUid(name);
+    }
+    return uid;
+}
+
 TypeId
 TypeId::LookupByName(std::string name)
 {
     NS_LOG_FUNCTION(name);
-    uint16_t uid = IidManager::Get()->GetUid(name);
+    uint16_t uid = GetUidRegistering(name);
     NS_ASSERT_MSG(uid, "Assert in TypeId::LookupByName: " << name << " not found");
     if (IidManager::Get()->GetDeprecatedName(uid) == name)
     {
@@ -886,7 +1074,7 @@ bool
 TypeId::LookupByNameFailSafe(std::string name, TypeId* tid)
 {
     NS_LOG_FUNCTION(name << tid->GetUid());
-    uint16_t uid = IidManager::Get()->GetUid(name);
+    uint16_t uid = GetUidRegistering(name);
     if (uid == 0)
     {
         return false;
@@ -904,6 +1092,11 @@ TypeId
 TypeId::LookupByHash(hash_t hash)
 {
     uint16_t uid = IidManager::Get()->GetUid(hash);
+    if (uid == 0)
+    {
+        IidManager::Get()->RegisterDeferred();
+        uid = IidManager::Get()->GetUid(hash);
+    }
     NS_ASSERT_MSG(uid != 0,
                   "Assert in TypeId::LookupByHash: 0x" << std::hex << hash << std::dec
                                                        << " not found");
@@ -915,6 +1108,11 @@ TypeId::LookupByHashFailSafe(hash_t hash, TypeId* tid)
 {
     uint16_t uid = IidManager::Get()->GetUid(hash);
     if (uid == 0)
+    {
+        IidManager::Get()->RegisterDeferred();
+        uid = IidManager::Get()->GetUid(hash);
+    }
+    if (uid == 0)
     {
         return false;
     }
@@ -926,6 +1124,7 @@ uint16_t
 TypeId::GetRegisteredN()
 {
     NS_LOG_FUNCTION_NOARGS();
+    IidManager::Get()->RegisterDeferred();
     return IidManager::Get()->GetRegisteredN();
 }
 
@@ -936,32 +1135,29 @@ TypeId::GetRegistered(uint16_t i)
     return TypeId(IidManager::Get()->GetRegistered(i));
 }
 
+void
+TypeId::DeferRegistration(const char* name, void (*registration)())
+{
+    StartupProfile::Timer timer(StartupProfile::TYPE_ID_DEFERRAL);
+    IidManager::Get()->Defer(name, registration);
+}
+
+void
+TypeId::RegisterDeferred()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    IidManager::Get()->RegisterDeferred();
+}
+
 std::tuple<bool, TypeId, TypeId::AttributeInformation>
 TypeId::FindAttribute(const TypeId& tid, const std::string& name)
 {
-    TypeId currentTid = tid;
-    TypeId parentTid;
-    while (true)
+    auto [uid, i] = IidManager::Get()->FindAttribute(tid.m_tid, name);
+    if (uid == 0)
     {
-        for (std::size_t i = 0; i < currentTid.GetAttributeN(); ++i)
-        {
-            const AttributeInformation& attributeInfo = currentTid.GetAttribute(i);
-            if (attributeInfo.name == name)
-            {
-                return {true, currentTid, attributeInfo};
-            }
-        }
-
-        parentTid = currentTid.GetParent();
-
-        if (parentTid == currentTid)
-        {
-            break;
-        }
-
-        currentTid = parentTid;
+        return {false, TypeId(), AttributeInformation()};
     }
-    return {false, TypeId(), AttributeInformation()};
+    return {true, TypeId(uid), IidManager::Get()->GetAttribute(uid, i)};
 }
 
 bool
@@ -1229,38 +1425,29 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name, TraceSourceInformation* info) const
 {
     NS_LOG_FUNCTION(this << name);
-    TypeId tid;
-    TypeId nextTid = *this;
-    TypeId::TraceSourceInformation tmp;
-    do
+    auto [uid, i] = IidManager::Get()->FindTraceSource(m_tid, name);
+    if (uid == 0)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-            tmp = tid.GetTraceSource(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == SupportLevel::SUPPORTED)
-                {
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == SupportLevel::DEPRECATED)
-                {
-                    std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == SupportLevel::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
-                                                   << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
+        return nullptr;
+    }
+    TypeId::TraceSourceInformation tmp = IidManager::Get()->GetTraceSource(uid, i);
+    if (tmp.supportLevel == SupportLevel::SUPPORTED)
+    {
+        *info = tmp;
+        return tmp.accessor;
+    }
+    else if (tmp.supportLevel == SupportLevel::DEPRECATED)
+    {
+        std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
+                  << std::endl;
+        *info = tmp;
+        return tmp.accessor;
+    }
+    else if (tmp.supportLevel == SupportLevel::OBSOLETE)
+    {
+        NS_FATAL_ERROR("TraceSource '" << name
+                                       << "' is obsolete, with no fallback: " << tmp.supportMsg);
+    }
     return nullptr;
 }
 
@@ -177,6 +177,28 @@ class TypeId
      */
     static TypeId GetRegistered(uint16_t i);
 
+    /**
+     * Defer the registration of a TypeId until it is looked up.
+     *
+     * This is used by NS_OBJECT_ENSURE_REGISTERED() and friends, so the
+     * TypeIds of the linked libraries aren't all built at startup.
+     * A lookup by name which misses registers first the deferred TypeIds
+     * of the classes named like the last part of the name, then all of
+     * them if still not found.  A lookup by hash which misses, or getting
+     * the number of registered TypeIds, registers all of them.
+     *
+     * @param [in] name The name of the class, without namespace.
+     * @param [in] registration The function registering the TypeId.
+     */
+    static void DeferRegistration(const char* name, void (*registration)());
+    /**
+     * Register the TypeIds whose registration was deferred.
+     *
+     * The registry isn't thread safe: this should be called before
+     * objects may be created from several threads.
+     */
+    static void RegisterDeferred();
+
     /**
      * Constructor.
      *
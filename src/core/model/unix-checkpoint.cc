@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "checkpoint.h"
+
+#include "abort.h"
+#include "default-simulator-impl.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "simulator-impl.h"
+#include "simulator.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup checkpoint
+ * ns3::Checkpoint implementation for POSIX systems.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Checkpoint");
+
+namespace
+{
+
+/** The branches forked by Branch(), not waited for yet. */
+std::vector<pid_t> g_branches;
+/** The checkpoint process taken by Save(), or -1. */
+pid_t g_standby = -1;
+/** The write end of the pipe the checkpoint process waits on, or -1. */
+int g_standbyFd = -1;
+/** Whether ReleaseStandby() is registered with std::atexit(). */
+bool g_atExit = false;
+/** The number of restores. */
+uint32_t g_restores = 0;
+
+/**
+ * Check that the process can be forked, and flush the output streams so
+ * that the buffered output is not written twice.
+ *
+ * @param [in] function The name of the calling function.
+ */
+void
+PrepareFork(const char* function)
+{
+    Ptr<SimulatorImpl> impl = Simulator::GetImplementation();
+    NS_ABORT_MSG_UNLESS(impl->GetInstanceTypeId() == DefaultSimulatorImpl::GetTypeId(),
+                        function << " requires the DefaultSimulatorImpl, not "
+                                 << impl->GetInstanceTypeId().GetName());
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+}
+
+/**
+ * Forget the checkpoint in a forked process, leaving it to the process
+ * which took it.
+ */
+void
+ForgetStandby()
+{
+    if (g_standbyFd != -1)
+    {
+        close(g_standbyFd);
+    }
+    g_standbyFd = -1;
+    g_standby = -1;
+}
+
+/** End the checkpoint process, as this one ends normally. */
+void
+ReleaseStandby()
+{
+    if (g_standby == -1)
+    {
+        return;
+    }
+    NS_LOG_LOGIC("releasing checkpoint " << g_standby);
+    // kill it before closing the pipe, which would restore it
+    kill(g_standby, SIGKILL);
+    waitpid(g_standby, nullptr, 0);
+    ForgetStandby();
+}
+
+} // unnamed namespace
+
+namespace Checkpoint
+{
+
+uint32_t
+Branch(uint32_t n)
+{
+    NS_LOG_FUNCTION(n);
+    NS_ASSERT_MSG(n > 0, "Checkpoint::Branch(): no branch");
+    PrepareFork("Checkpoint::Branch()");
+
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        pid_t pid = fork();
+        if (pid == -1)
+        {
+            NS_FATAL_ERROR("Checkpoint::Branch(): fork() failed: " << std::strerror(errno));
+        }
+        if (pid == 0)
+        {
+            g_branches.clear();
+            ForgetStandby();
+            return i;
+        }
+        NS_LOG_LOGIC("branch " << i << " is process " << pid);
+        g_branches.push_back(pid);
+    }
+    return 0;
+}
+
+uint32_t
+WaitBranches()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    uint32_t failures = 0;
+    for (pid_t pid : g_branches)
+    {
+        int status;
+        while (waitpid(pid, &status, 0) == -1)
+        {
+            if (errno != EINTR)
+            {
+                NS_FATAL_ERROR("Checkpoint::WaitBranches(): waitpid() failed: "
+                               << std::strerror(errno));
+            }
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            NS_LOG_LOGIC("branch process " << pid << " failed, status " << status);
+            failures++;
+        }
+    }
+    g_branches.clear();
+    return failures;
+}
+
+bool
+Save()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    PrepareFork("Checkpoint::Save()");
+    ReleaseStandby();
+
+    int fds[2];
+    if (pipe(fds) == -1)
+    {
+        NS_FATAL_ERROR("Checkpoint::Save(): pipe() failed: " << std::strerror(errno));
+    }
+    // the programs run by this process must not keep the pipe open
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        NS_FATAL_ERROR("Checkpoint::Save(): fork() failed: " << std::strerror(errno));
+    }
+    if (pid != 0)
+    {
+        close(fds[0]);
+        g_standby = pid;
+        g_standbyFd = fds[1];
+        if (!g_atExit)
+        {
+            std::atexit(&ReleaseStandby);
+            g_atExit = true;
+        }
+        NS_LOG_LOGIC("checkpoint at " << Simulator::Now() << " is process " << pid);
+        return false;
+    }
+
+    // The checkpoint: the pipe reaches end of file when the simulation
+    // process dies, unless it kills this one first.
+    close(fds[1]);
+    g_branches.clear();
+    char c;
+    ssize_t bytes;
+    do
+    {
+        bytes = read(fds[0], &c, 1);
+    } while (bytes == -1 && errno == EINTR);
+    close(fds[0]);
+    if (bytes != 0)
+    {
+        _exit(0);
+    }
+    g_restores++;
+    NS_LOG_INFO("restored the checkpoint at " << Simulator::Now());
+    return true;
+}
+
+uint32_t
+GetRestoreCount()
+{
+    return g_restores;
+}
+
+} // namespace Checkpoint
+
+} // namespace ns3
@@ -98,9 +98,11 @@ WallClockSynchronizer::DoSetOrigin(uint64_t ns)
     // that wall-clock time.  The wall clock will have been running for some
     // long time and will probably have a huge count of nanoseconds in it.  We
     // save the real time away so we can subtract it from "now" later and get
-    // a count of nanoseconds in real time since the simulation started.
+    // a count of nanoseconds in real time since the simulation started.  The
+    // simulation time of the origin is taken off, so that the normalized real
+    // time is ns now; this matters when the simulation resumes from ns > 0.
     //
-    m_realtimeOriginNano = GetRealtime();
+    m_realtimeOriginNano = GetRealtime() - ns;
     NS_LOG_INFO("origin = " << m_realtimeOriginNano);
 }
 
@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "checkpoint.h"
+
+#include "fatal-error.h"
+
+/**
+ * @file
+ * @ingroup checkpoint
+ * ns3::Checkpoint implementation for Windows, which cannot fork.
+ */
+
+namespace ns3
+{
+
+namespace Checkpoint
+{
+
+uint32_t
+Branch(uint32_t /* n */)
+{
+    NS_FATAL_ERROR("Checkpoint::Branch() is not supported on Windows");
+    return 0;
+}
+
+uint32_t
+WaitBranches()
+{
+    return 0;
+}
+
+bool
+Save()
+{
+    NS_FATAL_ERROR("Checkpoint::Save() is not supported on Windows");
+    return false;
+}
+
+uint32_t
+GetRestoreCount()
+{
+    return 0;
+}
+
+} // namespace Checkpoint
+
+} // namespace ns3
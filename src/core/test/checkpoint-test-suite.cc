@@ -0,0 +1,269 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/checkpoint.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup core-tests
+ * @ingroup checkpoint-tests
+ * Checkpoint test suite.
+ */
+
+/**
+ * @ingroup core-tests
+ * @defgroup checkpoint-tests Checkpoint test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * @ingroup checkpoint-tests
+ * Check that a branch, and a checkpoint restored after a crash, continue
+ * the simulation as it would have run.
+ *
+ * The simulation is a chain of events, each drawing the delay to the
+ * next one from a random variable.
+ */
+class CheckpointTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    CheckpointTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** A record of the simulation. */
+    struct Record
+    {
+        int64_t ts;   //!< The simulation time.
+        double value; //!< The value drawn.
+    };
+
+    /** Set up the simulation, which starts recording at time 0. */
+    void Setup();
+    /** Event recording the current time and scheduling the next one. */
+    void Next();
+    /** Event branching the simulation in two. */
+    void DoBranch();
+    /** Event saving a checkpoint. */
+    void DoSave();
+    /** Event crashing the simulation, unless restored. */
+    void Crash();
+
+    /**
+     * Write the records to a pipe, and close it.
+     *
+     * @param [in] fd The write end of the pipe.
+     */
+    void WriteRecords(int fd) const;
+    /**
+     * Read records from a pipe until its end, and close it.
+     *
+     * @param [in] fd The read end of the pipe.
+     * @returns The records.
+     */
+    static std::vector<Record> ReadRecords(int fd);
+    /**
+     * Check records against the reference run.
+     *
+     * @param [in] records The records.
+     * @param [in] what What made the records.
+     */
+    void CheckRecords(const std::vector<Record>& records, const std::string& what);
+
+    Ptr<UniformRandomVariable> m_random; //!< The delays between the events.
+    std::vector<Record> m_records;       //!< The records of this run.
+    std::vector<Record> m_reference;     //!< The records of the reference run.
+    uint32_t m_branch;                   //!< The branch index.
+};
+
+CheckpointTestCase::CheckpointTestCase()
+    : TestCase("Check that branches and restored checkpoints continue bit-identically")
+{
+}
+
+void
+CheckpointTestCase::Setup()
+{
+    Simulator::Destroy();
+    m_records.clear();
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetAttribute("Min", DoubleValue(0.5));
+    m_random->SetAttribute("Max", DoubleValue(1));
+    m_random->SetStream(7);
+    Simulator::Schedule(Seconds(0), &CheckpointTestCase::Next, this);
+}
+
+void
+CheckpointTestCase::Next()
+{
+    double value = m_random->GetValue();
+    m_records.push_back({Simulator::Now().GetTimeStep(), value});
+    if (m_records.size() < 10)
+    {
+        Simulator::Schedule(Seconds(value), &CheckpointTestCase::Next, this);
+    }
+}
+
+void
+CheckpointTestCase::DoBranch()
+{
+    m_branch = Checkpoint::Branch(2);
+}
+
+void
+CheckpointTestCase::DoSave()
+{
+    Checkpoint::Save();
+}
+
+void
+CheckpointTestCase::Crash()
+{
+    if (Checkpoint::GetRestoreCount() == 0)
+    {
+        _exit(1);
+    }
+}
+
+void
+CheckpointTestCase::WriteRecords(int fd) const
+{
+    const auto* data = reinterpret_cast<const char*>(m_records.data());
+    std::size_t size = m_records.size() * sizeof(Record);
+    while (size > 0)
+    {
+        ssize_t bytes = write(fd, data, size);
+        if (bytes <= 0)
+        {
+            break;
+        }
+        data += bytes;
+        size -= bytes;
+    }
+    close(fd);
+}
+
+std::vector<CheckpointTestCase::Record>
+CheckpointTestCase::ReadRecords(int fd)
+{
+    std::string bytes;
+    char buffer[256];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        bytes.append(buffer, n);
+    }
+    close(fd);
+    std::vector<Record> records(bytes.size() / sizeof(Record));
+    bytes.copy(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+    return records;
+}
+
+void
+CheckpointTestCase::CheckRecords(const std::vector<Record>& records, const std::string& what)
+{
+    NS_TEST_ASSERT_MSG_EQ(records.size(), m_reference.size(), what << ": wrong number of events");
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(records[i].ts, m_reference[i].ts, what << ": wrong time " << i);
+        // bit-identical, not just close
+        NS_TEST_EXPECT_MSG_EQ(records[i].value, m_reference[i].value, what << ": wrong value " << i);
+    }
+}
+
+void
+CheckpointTestCase::DoRun()
+{
+    Setup();
+    Simulator::Run();
+    m_reference = m_records;
+    NS_TEST_ASSERT_MSG_EQ(m_reference.size(), 10, "Wrong number of events");
+
+    // Branch at 2 s: both branches go on like the reference run
+    int fds[2];
+    NS_TEST_ASSERT_MSG_EQ(pipe(fds), 0, "No pipe");
+    Setup();
+    m_branch = 0;
+    Simulator::Schedule(Seconds(2), &CheckpointTestCase::DoBranch, this);
+    Simulator::Run();
+    if (m_branch == 1)
+    {
+        close(fds[0]);
+        WriteRecords(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    std::vector<Record> branch = ReadRecords(fds[0]);
+    NS_TEST_EXPECT_MSG_EQ(Checkpoint::WaitBranches(), 0, "Branch failed");
+    CheckRecords(m_records, "branch 0");
+    CheckRecords(branch, "branch 1");
+
+    // Save at 2 s and crash at 4 s, in a child process: the checkpoint
+    // goes on like the reference run
+    NS_TEST_ASSERT_MSG_EQ(pipe(fds), 0, "No pipe");
+    pid_t pid = fork();
+    NS_TEST_ASSERT_MSG_NE(pid, -1, "No fork");
+    if (pid == 0)
+    {
+        close(fds[0]);
+        Setup();
+        Simulator::Schedule(Seconds(2), &CheckpointTestCase::DoSave, this);
+        Simulator::Schedule(Seconds(4), &CheckpointTestCase::Crash, this);
+        Simulator::Run();
+        WriteRecords(fds[1]);
+        _exit(Checkpoint::GetRestoreCount() == 1 ? 0 : 2);
+    }
+    close(fds[1]);
+    std::vector<Record> restored = ReadRecords(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    NS_TEST_EXPECT_MSG_EQ(WIFEXITED(status) && WEXITSTATUS(status) == 1, true, "No crash");
+    CheckRecords(restored, "restored checkpoint");
+
+    Simulator::Destroy();
+    m_random = nullptr;
+}
+
+/**
+ * @ingroup checkpoint-tests
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    CheckpointTestSuite();
+};
+
+CheckpointTestSuite::CheckpointTestSuite()
+    : TestSuite("checkpoint")
+{
+    AddTestCase(new CheckpointTestCase());
+}
+
+/**
+ * @ingroup checkpoint-tests
+ * CheckpointTestSuite instance variable.
+ */
+static CheckpointTestSuite g_checkpointTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
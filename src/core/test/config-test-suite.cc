@@ -616,6 +616,18 @@ ObjectVectorConfigTestCase::DoRun()
 
     obj3->GetAttribute("A", iv);
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), -16, "Object Attribute \"A\" not set as expected");
+
+    //
+    // Overlapping ranges and indices past the end match each object once,
+    // in order
+    //
+    Config::MatchContainer matches = Config::LookupMatches("/NodeA/NodeB/NodesB/[2-9]|[1-2]|7");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 3, "Wrong number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(0), obj1, "Wrong first match");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(2), obj3, "Wrong last match");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetMatchedPath(1),
+                          "/NodeA/NodeB/NodesB/2/",
+                          "Wrong matched path");
 }
 
 /**
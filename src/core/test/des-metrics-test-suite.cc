@@ -0,0 +1,191 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/des-metrics.h"
+#include "ns3/global-value.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-path.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup core-tests
+ * @ingroup des-metrics-tests
+ * DesMetrics test suite.
+ */
+
+/**
+ * @ingroup core-tests
+ * @defgroup des-metrics-tests DesMetrics test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * @ingroup des-metrics-tests
+ * Check that a binary trace converts to the JSON trace of the same events.
+ */
+class DesMetricsBinaryTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    DesMetricsBinaryTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Write a trace of the same events in a format.
+     *
+     * @param [in] format The trace format.
+     * @returns The trace file name.
+     */
+    std::string WriteTrace(const std::string& format);
+
+    /**
+     * Split a JSON trace into its header and its sorted event records,
+     * leaving out the capture date.
+     *
+     * @param [in] json The JSON trace.
+     * @returns The lines.
+     */
+    static std::vector<std::string> SortedLines(const std::string& json);
+};
+
+DesMetricsBinaryTestCase::DesMetricsBinaryTestCase()
+    : TestCase("Check the binary trace and its conversion to JSON")
+{
+}
+
+std::string
+DesMetricsBinaryTestCase::WriteTrace(const std::string& format)
+{
+    GlobalValue::Bind("DesMetricsFormat", StringValue(format));
+    std::string name = "des-metrics-" + format;
+    std::list<std::string> path = SystemPath::Split(CreateTempDirFilename(name));
+    DesMetrics::Get()->Initialize({name}, SystemPath::Join(path.begin(), std::prev(path.end())));
+
+    // more than one buffer, from the main thread and from another one
+    for (int64_t i = 0; i < 10000; ++i)
+    {
+        DesMetrics::Get()->TraceWithContext(i % 7, NanoSeconds(i), NanoSeconds(3));
+    }
+    std::thread other([]() {
+        for (int64_t i = 0; i < 100; ++i)
+        {
+            DesMetrics::Get()->TraceWithContext(Simulator::NO_CONTEXT,
+                                                MicroSeconds(i),
+                                                NanoSeconds(5));
+        }
+    });
+    other.join();
+    DesMetrics::Get()->Close();
+    return CreateTempDirFilename(name + (format == "binary" ? ".bin" : ".json"));
+}
+
+std::vector<std::string>
+DesMetricsBinaryTestCase::SortedLines(const std::string& json)
+{
+    std::vector<std::string> lines;
+    std::istringstream is(json);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.find("capture_date") != std::string::npos ||
+            line.find("model_name") != std::string::npos)
+        {
+            continue;
+        }
+        // the records of the threads are interleaved differently
+        if (!line.empty() && line.back() == ',')
+        {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+void
+DesMetricsBinaryTestCase::DoRun()
+{
+    std::ifstream jsonFile(WriteTrace("json"));
+    std::ostringstream json;
+    json << jsonFile.rdbuf();
+
+    std::ifstream binary(WriteTrace("binary"), std::ios::binary);
+    NS_TEST_ASSERT_MSG_EQ(bool(binary), true, "No binary trace");
+    std::ostringstream converted;
+    NS_TEST_ASSERT_MSG_EQ(DesMetrics::ConvertToJson(binary, converted),
+                          true,
+                          "Conversion failed");
+
+    NS_TEST_EXPECT_MSG_EQ(json.str().substr(json.str().size() - 6),
+                          converted.str().substr(converted.str().size() - 6),
+                          "Different JSON trailers");
+    std::vector<std::string> expected = SortedLines(json.str());
+    std::vector<std::string> actual = SortedLines(converted.str());
+    NS_TEST_ASSERT_MSG_EQ(actual.size(), expected.size(), "Wrong number of lines");
+    NS_TEST_ASSERT_MSG_GT(actual.size(), 10100, "Missing records");
+    for (std::size_t i = 0; i < actual.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(actual[i], expected[i], "Different line " << i);
+    }
+
+    std::istringstream garbage("{ \"simulator_name\" : \"ns-3\" }");
+    std::ostringstream os;
+    NS_TEST_EXPECT_MSG_EQ(DesMetrics::ConvertToJson(garbage, os),
+                          false,
+                          "A JSON trace is not a binary trace");
+}
+
+void
+DesMetricsBinaryTestCase::DoTeardown()
+{
+    GlobalValue::Bind("DesMetricsFormat", StringValue("json"));
+    Simulator::Destroy();
+}
+
+/**
+ * @ingroup des-metrics-tests
+ * DesMetrics test suite.
+ */
+class DesMetricsTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    DesMetricsTestSuite();
+};
+
+DesMetricsTestSuite::DesMetricsTestSuite()
+    : TestSuite("des-metrics")
+{
+    AddTestCase(new DesMetricsBinaryTestCase());
+}
+
+/**
+ * @ingroup des-metrics-tests
+ * DesMetricsTestSuite instance variable.
+ */
+static DesMetricsTestSuite g_desMetricsTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,221 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+
+/**
+ * @file
+ * @ingroup core-tests
+ * @ingroup event-profiler-tests
+ * EventProfiler test suite.
+ */
+
+/**
+ * @ingroup core-tests
+ * @defgroup event-profiler-tests EventProfiler test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * @ingroup event-profiler-tests
+ * Check the event names, the sampling gaps and the report.
+ */
+class EventProfilerTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    EventProfilerTestCase();
+
+    /** Member function to make an event from. */
+    void Event();
+
+  private:
+    void DoRun() override;
+};
+
+EventProfilerTestCase::EventProfilerTestCase()
+    : TestCase("Check the event names, the sampling gaps and the report")
+{
+}
+
+void
+EventProfilerTestCase::Event()
+{
+}
+
+/** Function to make an event from. */
+static void
+EventProfilerTestFunction(int)
+{
+}
+
+void
+EventProfilerTestCase::DoRun()
+{
+    EventImpl* member = MakeEvent(&EventProfilerTestCase::Event, this);
+    EventImpl* function = MakeEvent(&EventProfilerTestFunction, 1);
+    std::string memberName = EventProfiler::GetEventName(typeid(*member));
+    std::string functionName = EventProfiler::GetEventName(typeid(*function));
+    NS_TEST_EXPECT_MSG_EQ(memberName,
+                          "void (ns3::tests::EventProfilerTestCase::*)()",
+                          "Wrong name for a member function event");
+    NS_TEST_EXPECT_MSG_EQ(functionName, "void (*)(int)", "Wrong name for a function event");
+
+    EventProfiler profiler;
+    NS_TEST_EXPECT_MSG_EQ(profiler.NextGap(),
+                          std::numeric_limits<uint64_t>::max(),
+                          "Sampling should be disabled by default");
+    profiler.SetInterval(10);
+    uint64_t sum = 0;
+    const uint64_t draws = 10000;
+    for (uint64_t i = 0; i < draws; ++i)
+    {
+        uint64_t gap = profiler.NextGap();
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(gap, 1, "Gap too small");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(gap, 19, "Gap too large");
+        sum += gap;
+    }
+    NS_TEST_EXPECT_MSG_EQ_TOL(sum / static_cast<double>(draws), 10, 0.2, "Wrong average gap");
+
+    for (int i = 0; i < 3; ++i)
+    {
+        profiler.Record(typeid(*member), 4, 2000);
+    }
+    profiler.Record(typeid(*function), Simulator::NO_CONTEXT, 4000);
+    NS_TEST_EXPECT_MSG_EQ(profiler.GetSampleCount(), 4, "Wrong sample count");
+
+    std::ostringstream report;
+    profiler.Report(report, 1);
+    // times and counts are scaled by the interval; the member function
+    // events take the most time
+    NS_TEST_EXPECT_MSG_NE(report.str().find("30  " + memberName),
+                          std::string::npos,
+                          "Missing event line in\n" << report.str());
+    NS_TEST_EXPECT_MSG_EQ(report.str().find(functionName),
+                          std::string::npos,
+                          "Extra event line in\n" << report.str());
+    NS_TEST_EXPECT_MSG_NE(report.str().find("30  node 4"),
+                          std::string::npos,
+                          "Missing context line in\n" << report.str());
+
+    std::ostringstream folded;
+    profiler.WriteFlameGraph(folded);
+    std::string expected = functionName + ";no context 40\n" + memberName + ";node 4 60\n";
+    NS_TEST_EXPECT_MSG_EQ(folded.str(), expected, "Wrong flame graph");
+
+    profiler.Clear();
+    NS_TEST_EXPECT_MSG_EQ(profiler.GetSampleCount(), 0, "Samples not cleared");
+
+    member->Unref();
+    function->Unref();
+}
+
+/**
+ * @ingroup event-profiler-tests
+ * Check the profile written by the DefaultSimulatorImpl.
+ */
+class EventProfilerSimulatorTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    EventProfilerSimulatorTestCase();
+
+    /** Member function to make the events from. */
+    void Event();
+
+  private:
+    void DoRun() override;
+};
+
+EventProfilerSimulatorTestCase::EventProfilerSimulatorTestCase()
+    : TestCase("Check the profile of the DefaultSimulatorImpl")
+{
+}
+
+void
+EventProfilerSimulatorTestCase::Event()
+{
+}
+
+void
+EventProfilerSimulatorTestCase::DoRun()
+{
+    std::string file = CreateTempDirFilename("event-profile.folded");
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    factory.Set("ProfileInterval", UintegerValue(1));
+    factory.Set("ProfileTopN", UintegerValue(0));
+    factory.Set("ProfileFile", StringValue(file));
+    Simulator::Destroy();
+    Simulator::SetImplementation(factory.Create<SimulatorImpl>());
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        Simulator::ScheduleWithContext(i % 2,
+                                       MicroSeconds(i),
+                                       &EventProfilerSimulatorTestCase::Event,
+                                       this);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream folded(file);
+    std::map<std::string, uint64_t> stacks;
+    std::string line;
+    while (std::getline(folded, line))
+    {
+        auto space = line.rfind(' ');
+        NS_TEST_ASSERT_MSG_NE(space, std::string::npos, "Bad line " << line);
+        stacks[line.substr(0, space)] = std::stoull(line.substr(space + 1));
+    }
+    std::string name = "void (ns3::tests::EventProfilerSimulatorTestCase::*)()";
+    NS_TEST_EXPECT_MSG_EQ(stacks.size(), 2, "Wrong number of stacks");
+    NS_TEST_EXPECT_MSG_EQ(stacks.count(name + ";node 0"), 1, "Missing stack for node 0");
+    NS_TEST_EXPECT_MSG_EQ(stacks.count(name + ";node 1"), 1, "Missing stack for node 1");
+}
+
+/**
+ * @ingroup event-profiler-tests
+ * EventProfiler test suite.
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    EventProfilerTestSuite();
+};
+
+EventProfilerTestSuite::EventProfilerTestSuite()
+    : TestSuite("event-profiler")
+{
+    AddTestCase(new EventProfilerTestCase());
+    AddTestCase(new EventProfilerSimulatorTestCase());
+}
+
+/**
+ * @ingroup event-profiler-tests
+ * EventProfilerTestSuite instance variable.
+ */
+static EventProfilerTestSuite g_eventProfilerTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
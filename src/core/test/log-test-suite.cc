@@ -0,0 +1,275 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/log-binary-sink.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+
+/**
+ * @file
+ * @ingroup log-tests
+ * Logging test suite.
+ */
+
+/**
+ * @ingroup core-tests
+ * @defgroup log-tests Logging tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogTestSuite");
+
+/**
+ * @ingroup log-tests
+ * A log component with only the errors compiled in.
+ */
+static CompiledLogComponent<LOG_ERROR> g_logCompiledError("LogTestSuiteCompiled", __FILE__);
+
+/**
+ * @ingroup log-tests
+ *
+ * Check the selection of the log levels compiled in.
+ */
+class LogCompiledLevelsTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LogCompiledLevelsTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LogCompiledLevelsTestCase::LogCompiledLevelsTestCase()
+    : TestCase("Check the selection of the log levels compiled in")
+{
+}
+
+void
+LogCompiledLevelsTestCase::DoRun()
+{
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("", "A"), LOG_NONE, "Nothing selected");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("A", "A"), LOG_LEVEL_ALL, "No options");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("A=", "A"), LOG_LEVEL_ALL, "Empty options");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("A=debug|info", "A"),
+                          (LOG_DEBUG | LOG_INFO),
+                          "Two levels");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("A=level_warn|prefix_time", "A"),
+                          LOG_LEVEL_WARN,
+                          "Prefixes are ignored");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("A=**", "A"), LOG_LEVEL_ALL, "Wildcard option");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("B=debug:*=error", "A"),
+                          LOG_ERROR,
+                          "Wildcard component");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("B=debug:A=warn:A=error", "A"),
+                          (LOG_WARN | LOG_ERROR),
+                          "Component listed twice");
+    NS_TEST_EXPECT_MSG_EQ(LogCompiledLevels("AB:B", "A"), LOG_NONE, "Component not listed");
+    static_assert(LogCompiledLevels("Ipv4L3Protocol=debug", "Ipv4L3Protocol") == LOG_DEBUG,
+                  "The levels are known at compile time");
+
+    g_logCompiledError.Enable(LOG_LEVEL_ALL);
+    NS_TEST_EXPECT_MSG_EQ(g_logCompiledError.IsEnabled(LOG_ERROR), true, "Error compiled in");
+    NS_TEST_EXPECT_MSG_EQ(g_logCompiledError.IsEnabled(LOG_DEBUG), false, "Debug compiled out");
+    NS_TEST_EXPECT_MSG_EQ(g_logCompiledError.LogComponent::IsEnabled(LOG_DEBUG),
+                          false,
+                          "Debug masked at run time");
+
+#ifdef NS3_LOG_ENABLE
+    // The NS_LOG statements of the levels compiled out don't evaluate
+    // their arguments, or even exist
+    std::ostringstream output;
+    std::streambuf* clog = std::clog.rdbuf(output.rdbuf());
+    int evaluated = 0;
+    {
+        auto& g_log = g_logCompiledError;
+        NS_LOG_ERROR("error " << ++evaluated);
+        NS_LOG_DEBUG("debug " << ++evaluated);
+        NS_LOG_FUNCTION(++evaluated);
+    }
+    std::clog.rdbuf(clog);
+    NS_TEST_EXPECT_MSG_EQ(evaluated, 1, "Only the error is logged");
+    NS_TEST_EXPECT_MSG_EQ(output.str(), "error 1\n", "Output of the error");
+#endif
+    g_logCompiledError.Disable(LOG_LEVEL_ALL);
+}
+
+/**
+ * @ingroup log-tests
+ *
+ * Check the LogBinarySink decodes to the text logged to \c std::clog.
+ */
+class LogBinarySinkTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LogBinarySinkTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Log a message of each level, with arguments of many types.
+     *
+     * @param [in] n A number to log.
+     */
+    void LogMessages(int n);
+
+    /**
+     * Log messages outside and inside a simulation.
+     *
+     * @return The number of NS_LOG statements.
+     */
+    int LogAll();
+
+    /**
+     * Log to \c std::clog.
+     *
+     * @return The text logged.
+     */
+    std::string LogText();
+
+    /**
+     * Log to the LogBinarySink, and decode the file.
+     *
+     * @param [in] capacity The size of the ring buffer.
+     * @return The text decoded.
+     */
+    std::string LogBinary(std::size_t capacity);
+};
+
+LogBinarySinkTestCase::LogBinarySinkTestCase()
+    : TestCase("Check the LogBinarySink decodes to the text logged to std::clog")
+{
+}
+
+void
+LogBinarySinkTestCase::LogMessages(int n)
+{
+    uint8_t small = 65;
+    int8_t negative = -3;
+    float f = 0.1F;
+    std::string s = "string";
+    NS_LOG_FUNCTION(this << n << s << small);
+    NS_LOG_FUNCTION_NOARGS();
+    NS_LOG_DEBUG("int " << n << " " << -1234567890123LL << " " << 42U << " char " << 'c' << small
+                        << negative);
+    NS_LOG_INFO("bool " << true << " " << false << " double " << 3.14159265358979 << " " << 1e-300
+                        << " float " << f);
+    NS_LOG_WARN("string " << s << " " << std::string_view("view") << " pointer " << this << " "
+                          << static_cast<const void*>(nullptr));
+    NS_LOG_LOGIC("time " << Seconds(1.5) << " then " << 7 << " hex " << std::hex << 255 << " "
+                         << std::setw(6) << 10);
+    NS_LOG_ERROR("manipulators " << std::hex << 255 << std::dec << " " << 255 << std::endl
+                                 << "next line");
+}
+
+int
+LogBinarySinkTestCase::LogAll()
+{
+    LogMessages(1);
+    Simulator::ScheduleWithContext(3, Seconds(1.25), &LogBinarySinkTestCase::LogMessages, this, 2);
+    Simulator::Schedule(NanoSeconds(2000000001), &LogBinarySinkTestCase::LogMessages, this, 3);
+    Simulator::Run();
+    Simulator::Destroy();
+    return 3 * 7;
+}
+
+std::string
+LogBinarySinkTestCase::LogText()
+{
+    std::ostringstream output;
+    std::streambuf* clog = std::clog.rdbuf(output.rdbuf());
+    LogAll();
+    std::clog.rdbuf(clog);
+    return output.str();
+}
+
+std::string
+LogBinarySinkTestCase::LogBinary(std::size_t capacity)
+{
+    std::string filename = CreateTempDirFilename("log-binary-sink.bin");
+    LogBinarySink::Open(filename, capacity);
+    NS_TEST_EXPECT_MSG_EQ(LogBinarySink::IsOpen(), true, "Sink open");
+    int count = LogAll();
+    LogBinarySink::Close();
+    NS_TEST_EXPECT_MSG_EQ(LogBinarySink::IsOpen(), false, "Sink closed");
+
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream output;
+    NS_TEST_EXPECT_MSG_EQ(LogBinarySink::Decode(file, output), count, "Messages decoded");
+    return output.str();
+}
+
+void
+LogBinarySinkTestCase::DoRun()
+{
+#ifdef NS3_LOG_ENABLE
+    if ((decltype(g_log)::COMPILED & LOG_LEVEL_ALL) != LOG_LEVEL_ALL)
+    {
+        // The build compiles out some of the messages
+        return;
+    }
+    g_log.Enable(LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+
+    std::string text = LogText();
+    NS_TEST_EXPECT_MSG_NE(text.find("+1.250000000s 3 LogTestSuite:LogMessages(): [DEBUG] int 2"),
+                          std::string::npos,
+                          "Time and context prefixes");
+    NS_TEST_EXPECT_MSG_EQ(LogBinary(1 << 16), text, "Decoded text");
+    // Records larger than the ring buffer go through in pieces
+    NS_TEST_EXPECT_MSG_EQ(LogBinary(64), text, "Decoded text, small ring buffer");
+
+    g_log.Disable(LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+    g_log.Enable(LOG_LEVEL_ALL);
+    text = LogText();
+    NS_TEST_EXPECT_MSG_EQ(LogBinary(1 << 16), text, "Decoded text, no prefixes");
+    g_log.Disable(LOG_LEVEL_ALL);
+
+    std::istringstream empty;
+    std::ostringstream output;
+    NS_TEST_EXPECT_MSG_EQ(LogBinarySink::Decode(empty, output), -1, "Not a binary log");
+#endif
+}
+
+/**
+ * @ingroup log-tests
+ *
+ * Logging test suite.
+ */
+class LogTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    LogTestSuite();
+};
+
+LogTestSuite::LogTestSuite()
+    : TestSuite("log")
+{
+    AddTestCase(new LogCompiledLevelsTestCase);
+    AddTestCase(new LogBinarySinkTestCase);
+}
+
+/**
+ * @ingroup log-tests
+ * Static variable for test initialization.
+ */
+static LogTestSuite g_logTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -13,6 +13,7 @@
 #include "ns3/double.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/shuffle.h"
@@ -3087,6 +3088,90 @@ LargestExtremeValueTestCase::DoRun()
                               "Wrong variance value.");
 }
 
+/**
+ * @ingroup rng-tests
+ * Test that GetValues() draws the same values as GetValue(), and leaves
+ * the stream in the same state.
+ */
+class GetValuesTestCase : public TestCase
+{
+  public:
+    GetValuesTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check a distribution, configured by a factory.
+     *
+     * @param [in] factory The factory of the random variables.
+     */
+    void Check(const ObjectFactory& factory);
+};
+
+GetValuesTestCase::GetValuesTestCase()
+    : TestCase("Check that GetValues() draws the values GetValue() would")
+{
+}
+
+void
+GetValuesTestCase::Check(const ObjectFactory& factory)
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    Ptr<RandomVariableStream> scalar = factory.Create<RandomVariableStream>();
+    Ptr<RandomVariableStream> batch = factory.Create<RandomVariableStream>();
+    scalar->SetStream(3);
+    batch->SetStream(3);
+
+    std::string what = factory.GetTypeId().GetName();
+    // sizes about the chunks of the batch kernel, and odd ones for the
+    // pairs of the normal distribution
+    for (std::size_t size : {0, 1, 7, 127, 128, 129, 1000, 4099})
+    {
+        std::vector<double> values(size);
+        batch->GetValues(values);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            // bit-identical, not just close
+            NS_TEST_ASSERT_MSG_EQ(values[i],
+                                  scalar->GetValue(),
+                                  what << ": wrong value " << i << " of " << size);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(batch->GetValue(), scalar->GetValue(), what << ": wrong state");
+}
+
+void
+GetValuesTestCase::DoRun()
+{
+    ObjectFactory uniform("ns3::UniformRandomVariable",
+                          "Min",
+                          DoubleValue(-3),
+                          "Max",
+                          DoubleValue(5));
+    Check(uniform);
+    uniform.Set("Antithetic", BooleanValue(true));
+    Check(uniform);
+
+    ObjectFactory exponential("ns3::ExponentialRandomVariable", "Mean", DoubleValue(2));
+    Check(exponential);
+    // the bound rejects some of the values
+    exponential.Set("Bound", DoubleValue(3));
+    Check(exponential);
+
+    ObjectFactory normal("ns3::NormalRandomVariable", "Mean", DoubleValue(1));
+    normal.Set("Variance", DoubleValue(4));
+    Check(normal);
+    normal.Set("Bound", DoubleValue(2.5));
+    Check(normal);
+    normal.Set("Antithetic", BooleanValue(true));
+    Check(normal);
+
+    // the base implementation
+    Check(ObjectFactory("ns3::ParetoRandomVariable"));
+}
+
 /**
  * @ingroup rng-tests
  * RandomVariableStream test suite, covering all random number variable
@@ -3146,6 +3231,7 @@ RandomVariableSuite::RandomVariableSuite()
     AddTestCase(new ShuffleElementsTest);
     AddTestCase(new LaplacianTestCase);
     AddTestCase(new LargestExtremeValueTestCase);
+    AddTestCase(new GetValuesTestCase);
 }
 
 static RandomVariableSuite randomVariableSuite; //!< Static variable for test initialization
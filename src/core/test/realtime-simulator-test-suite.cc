@@ -0,0 +1,264 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/make-event.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/realtime-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup core-tests
+ * @ingroup realtime-simulator-tests
+ * RealtimeSimulatorImpl test suite.
+ */
+
+/**
+ * @ingroup core-tests
+ * @defgroup realtime-simulator-tests RealtimeSimulatorImpl test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * @ingroup realtime-simulator-tests
+ * Check the lag statistics after an overload, and that the simulation
+ * catches up and is paced again.
+ */
+class RealtimeLagTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * @param [in] mode The synchronization mode.
+     */
+    RealtimeLagTestCase(RealtimeSimulatorImpl::SynchronizationMode mode);
+
+  private:
+    void DoRun() override;
+
+    /** Event keeping the simulator busy for longer than the next events. */
+    void Overload();
+    /** Event recording its real time. */
+    void Record();
+    /**
+     * Sink of the MaxLag trace source.
+     *
+     * @param [in] oldValue The previous maximum lag.
+     * @param [in] newValue The new maximum lag.
+     */
+    void MaxLag(Time oldValue, Time newValue);
+    /**
+     * Sink of the LagHistogram trace source.
+     *
+     * @param [in] histogram The lag histogram.
+     */
+    void LagHistogram(const std::vector<uint64_t>& histogram);
+
+    RealtimeSimulatorImpl::SynchronizationMode m_mode; //!< The synchronization mode.
+    Ptr<RealtimeSimulatorImpl> m_impl;                 //!< The simulator implementation.
+    std::vector<Time> m_realtimes;                     //!< Real times of the Record() events.
+    Time m_maxLag;                                     //!< Last value of the MaxLag trace.
+    std::vector<uint64_t> m_histogram;                 //!< Last LagHistogram trace.
+};
+
+RealtimeLagTestCase::RealtimeLagTestCase(RealtimeSimulatorImpl::SynchronizationMode mode)
+    : TestCase(std::string("Check the lag statistics in ") +
+               (mode == RealtimeSimulatorImpl::SYNC_CATCH_UP ? "CatchUp" : "BestEffort") +
+               " mode"),
+      m_mode(mode)
+{
+}
+
+void
+RealtimeLagTestCase::Overload()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+void
+RealtimeLagTestCase::Record()
+{
+    m_realtimes.push_back(m_impl->RealtimeNow());
+}
+
+void
+RealtimeLagTestCase::MaxLag(Time /* oldValue */, Time newValue)
+{
+    m_maxLag = newValue;
+}
+
+void
+RealtimeLagTestCase::LagHistogram(const std::vector<uint64_t>& histogram)
+{
+    m_histogram = histogram;
+}
+
+void
+RealtimeLagTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::RealtimeSimulatorImpl");
+    factory.Set("SynchronizationMode", EnumValue(m_mode));
+    m_impl = factory.Create<RealtimeSimulatorImpl>();
+    Simulator::Destroy();
+    Simulator::SetImplementation(m_impl);
+    m_impl->TraceConnectWithoutContext("MaxLag", MakeCallback(&RealtimeLagTestCase::MaxLag, this));
+    m_impl->TraceConnectWithoutContext("LagHistogram",
+                                       MakeCallback(&RealtimeLagTestCase::LagHistogram, this));
+
+    // the events at 1 to 50 ms are due while Overload() runs, the last
+    // one is not
+    Simulator::Schedule(Time(0), &RealtimeLagTestCase::Overload, this);
+    for (int i = 1; i <= 50; ++i)
+    {
+        Simulator::Schedule(MilliSeconds(i), &RealtimeLagTestCase::Record, this);
+    }
+    Simulator::Schedule(MilliSeconds(200), &RealtimeLagTestCase::Record, this);
+    Simulator::Stop(MilliSeconds(210));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_realtimes.size(), 51, "Wrong number of events");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_realtimes[0], MilliSeconds(100), "First event not late");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_realtimes[50], MilliSeconds(200), "Last event not paced");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_impl->GetMaxLag(), MilliSeconds(98), "Max lag too small");
+    NS_TEST_EXPECT_MSG_EQ(m_maxLag, m_impl->GetMaxLag(), "Wrong MaxLag trace");
+    NS_TEST_EXPECT_MSG_LT(m_impl->GetLag(), MilliSeconds(50), "Last event too late");
+
+    std::vector<uint64_t> histogram = m_impl->GetLagHistogram();
+    NS_TEST_ASSERT_MSG_EQ(histogram.size(),
+                          RealtimeSimulatorImpl::LAG_HISTOGRAM_BUCKETS,
+                          "Wrong number of buckets");
+    NS_TEST_EXPECT_MSG_EQ(std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)),
+                          53,
+                          "Wrong number of events in the histogram");
+    // 2^15 us < 49 ms < 2^16 us < 99 ms < 2^17 us
+    NS_TEST_EXPECT_MSG_GT(histogram[16] + histogram[17], 0, "Missing late events");
+    NS_TEST_EXPECT_MSG_EQ((m_histogram == histogram), true, "Wrong LagHistogram trace");
+
+    Simulator::Destroy();
+    m_impl = nullptr;
+}
+
+/**
+ * @ingroup realtime-simulator-tests
+ * Check that the simulation runs as fast as possible, except in a paced
+ * window.
+ */
+class RealtimePacedTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    RealtimePacedTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Event recording its simulation time and the wall clock. */
+    void Record();
+    /** Event scheduling Record() in real time. */
+    void ScheduleRealtime();
+
+    Ptr<RealtimeSimulatorImpl> m_impl; //!< The simulator implementation.
+    std::vector<std::pair<Time, double>> m_records; //!< Simulation and wall clock (s) times.
+};
+
+RealtimePacedTestCase::RealtimePacedTestCase()
+    : TestCase("Check fast-forwarding around a paced window")
+{
+}
+
+void
+RealtimePacedTestCase::Record()
+{
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now().time_since_epoch();
+    m_records.emplace_back(Simulator::Now(), wall.count());
+}
+
+void
+RealtimePacedTestCase::ScheduleRealtime()
+{
+    m_impl->ScheduleRealtime(MilliSeconds(1), MakeEvent(&RealtimePacedTestCase::Record, this));
+}
+
+void
+RealtimePacedTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::RealtimeSimulatorImpl");
+    factory.Set("Paced", BooleanValue(false));
+    m_impl = factory.Create<RealtimeSimulatorImpl>();
+    Simulator::Destroy();
+    Simulator::SetImplementation(m_impl);
+
+    // 100 s of simulation time, of which only 10 s + [0, 100] ms are paced
+    m_impl->SetPacedWindow(Seconds(10), Seconds(10) + MilliSeconds(100));
+    for (int i = 0; i < 100; ++i)
+    {
+        Simulator::Schedule(Seconds(i), &RealtimePacedTestCase::Record, this);
+    }
+    Simulator::Schedule(Seconds(10) + MilliSeconds(100), &RealtimePacedTestCase::Record, this);
+    Simulator::Schedule(Seconds(50), &RealtimePacedTestCase::ScheduleRealtime, this);
+    Simulator::Stop(Seconds(100));
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    NS_TEST_ASSERT_MSG_EQ(m_records.size(), 102, "Wrong number of events");
+    NS_TEST_EXPECT_MSG_LT(wall.count(), 5, "Not fast-forwarded");
+    NS_TEST_EXPECT_MSG_EQ(m_records[11].first,
+                          Seconds(10) + MilliSeconds(100),
+                          "Wrong event order");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_records[11].second - m_records[10].second,
+                                0.099,
+                                "Window not paced");
+    NS_TEST_EXPECT_MSG_EQ(m_records[52].first,
+                          Seconds(50) + MilliSeconds(1),
+                          "Wrong real time event while fast-forwarding");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->IsPaced(), false, "Paced after the window");
+
+    Simulator::Destroy();
+    m_impl = nullptr;
+}
+
+/**
+ * @ingroup realtime-simulator-tests
+ * RealtimeSimulatorImpl test suite.
+ */
+class RealtimeSimulatorTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    RealtimeSimulatorTestSuite();
+};
+
+RealtimeSimulatorTestSuite::RealtimeSimulatorTestSuite()
+    : TestSuite("realtime-simulator")
+{
+    AddTestCase(new RealtimeLagTestCase(RealtimeSimulatorImpl::SYNC_BEST_EFFORT));
+    AddTestCase(new RealtimeLagTestCase(RealtimeSimulatorImpl::SYNC_CATCH_UP));
+    AddTestCase(new RealtimePacedTestCase());
+}
+
+/**
+ * @ingroup realtime-simulator-tests
+ * RealtimeSimulatorTestSuite instance variable.
+ */
+static RealtimeSimulatorTestSuite g_realtimeSimulatorTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
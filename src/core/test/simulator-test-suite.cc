@@ -5,13 +5,20 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/boolean.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
 
 using namespace ns3;
 
@@ -200,6 +207,217 @@ SimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_destroy, true, "Event should have run");
 }
 
+/**
+ * @ingroup simulator-tests
+ *
+ * @brief Check that a scheduler returns events in the same order as the
+ * MapScheduler, under a random mix of Insert(), RemoveNext(), RemoveNextBatch()
+ * and Remove()
+ * with heavily clustered time stamps.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * @param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check event order of " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    Ptr<Scheduler> reference = CreateObject<MapScheduler>();
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    std::vector<Scheduler::Event> pending;
+    auto erasePending = [&pending](const Scheduler::Event& ev) {
+        for (auto& p : pending)
+        {
+            if (p.key.m_uid == ev.key.m_uid)
+            {
+                p = pending.back();
+                pending.pop_back();
+                break;
+            }
+        }
+    };
+    uint64_t now = 0;
+    uint32_t uid = 0;
+    for (uint32_t step = 0; step < 50000; ++step)
+    {
+        double op = rng->GetValue();
+        if (op < 0.55 || reference->IsEmpty())
+        {
+            // half of the events share the current time stamp, the others
+            // fall on a coarse grid, with a few far in the future
+            uint64_t delay = 0;
+            double kind = rng->GetValue();
+            if (kind < 0.45)
+            {
+                delay = 1000 * rng->GetInteger(1, 20);
+            }
+            else if (kind < 0.5)
+            {
+                delay = 1000000 * rng->GetInteger(1, 100);
+            }
+            Scheduler::Event ev{nullptr, {now + delay, uid++, 0}};
+            scheduler->Insert(ev);
+            reference->Insert(ev);
+            pending.push_back(ev);
+        }
+        else if (op < 0.8)
+        {
+            Scheduler::Event expected = reference->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                                  expected.key.m_uid,
+                                  "wrong next event at step " << step);
+            Scheduler::Event ev = scheduler->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid,
+                                  expected.key.m_uid,
+                                  "wrong event removed at step " << step);
+            now = ev.key.m_ts;
+            erasePending(ev);
+        }
+        else if (op < 0.9)
+        {
+            std::vector<Scheduler::Event> batch;
+            scheduler->RemoveNextBatch(batch);
+            for (const auto& ev : batch)
+            {
+                NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid,
+                                      reference->RemoveNext().key.m_uid,
+                                      "wrong event in batch at step " << step);
+                erasePending(ev);
+            }
+            now = batch.back().key.m_ts;
+            NS_TEST_ASSERT_MSG_EQ(reference->IsEmpty() || reference->PeekNext().key.m_ts > now,
+                                  true,
+                                  "incomplete batch at step " << step);
+        }
+        else
+        {
+            uint32_t i = rng->GetInteger(0, pending.size() - 1);
+            scheduler->Remove(pending[i]);
+            reference->Remove(pending[i]);
+            pending[i] = pending.back();
+            pending.pop_back();
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), reference->IsEmpty(), "wrong IsEmpty");
+    }
+    while (!reference->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(scheduler->RemoveNext().key.m_uid,
+                              reference->RemoveNext().key.m_uid,
+                              "wrong event removed while draining");
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "events left over");
+}
+
+/**
+ * @ingroup simulator-tests
+ *
+ * @brief Check the order of events with the same time stamp, which
+ * DefaultSimulatorImpl runs as a batch, when they remove, cancel and
+ * schedule each other or stop the simulator.
+ */
+class SimulatorBatchTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * @param schedulerFactory Scheduler factory.
+     * @param batchEvents Value of the BatchEvents attribute.
+     */
+    SimulatorBatchTestCase(ObjectFactory schedulerFactory, bool batchEvents);
+    void DoRun() override;
+
+  private:
+    /**
+     * Test event, recording its index.
+     * @param i The event index.
+     */
+    void Event(uint32_t i);
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    bool m_batchEvents;               //!< Value of the BatchEvents attribute.
+    std::vector<EventId> m_ids;       //!< The events scheduled by DoRun().
+    std::vector<uint32_t> m_order;    //!< The indices of the events run.
+};
+
+SimulatorBatchTestCase::SimulatorBatchTestCase(ObjectFactory schedulerFactory, bool batchEvents)
+    : TestCase("Check the order of simultaneous events with " +
+               schedulerFactory.GetTypeId().GetName() +
+               (batchEvents ? ", batched" : ", not batched")),
+      m_schedulerFactory(schedulerFactory),
+      m_batchEvents(batchEvents)
+{
+}
+
+void
+SimulatorBatchTestCase::Event(uint32_t i)
+{
+    m_order.push_back(i);
+    switch (i)
+    {
+    case 2:
+        Simulator::Remove(m_ids[5]);
+        break;
+    case 3:
+        Simulator::Cancel(m_ids[6]);
+        break;
+    case 4:
+        Simulator::ScheduleNow(&SimulatorBatchTestCase::Event, this, 10);
+        break;
+    case 7:
+        Simulator::Stop();
+        break;
+    }
+}
+
+void
+SimulatorBatchTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    factory.Set("BatchEvents", BooleanValue(m_batchEvents));
+    Simulator::Destroy();
+    Simulator::SetImplementation(factory.Create<SimulatorImpl>());
+    Simulator::SetScheduler(m_schedulerFactory);
+
+    Simulator::Schedule(MicroSeconds(2), &SimulatorBatchTestCase::Event, this, 11);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        m_ids.push_back(
+            Simulator::Schedule(MicroSeconds(1), &SimulatorBatchTestCase::Event, this, i));
+    }
+    Simulator::Run();
+    std::vector<uint32_t> expected{0, 1, 2, 3, 4, 7};
+    NS_TEST_EXPECT_MSG_EQ((m_order == expected), true, "Wrong events before Stop()");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(1), "Wrong time after Stop()");
+    NS_TEST_EXPECT_MSG_EQ(m_ids[5].IsExpired(), true, "Removed event not expired");
+    NS_TEST_EXPECT_MSG_EQ(m_ids[8].IsPending(), true, "Event after Stop() not pending");
+
+    Simulator::Run();
+    expected.insert(expected.end(), {8, 9, 10, 11});
+    NS_TEST_EXPECT_MSG_EQ((m_order == expected), true, "Wrong events after Stop()");
+    // the cancelled event counts, the removed one does not
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetEventCount(), 11, "Wrong event count");
+    Simulator::Destroy();
+}
+
 /**
  * @ingroup simulator-tests
  *
@@ -726,6 +944,37 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+
+        for (bool batchEvents : {true, false})
+        {
+            for (TypeId tid : {ListScheduler::GetTypeId(),
+                               MapScheduler::GetTypeId(),
+                               HeapScheduler::GetTypeId(),
+                               LadderScheduler::GetTypeId()})
+            {
+                factory.SetTypeId(tid);
+                AddTestCase(new SimulatorBatchTestCase(factory, batchEvents),
+                            TestCase::Duration::QUICK);
+            }
+        }
+
+        factory.SetTypeId(ListScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(MapScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(HeapScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(CalendarScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
+        factory.Set("Threshold", UintegerValue(4));
+        factory.Set("MaxRungs", UintegerValue(3));
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::Duration::QUICK);
     }
 };
 
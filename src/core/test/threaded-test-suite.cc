@@ -14,11 +14,13 @@
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <atomic>
 #include <chrono> // seconds, milliseconds
 #include <ctime>
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -267,6 +269,149 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * @ingroup threaded-tests
+ *
+ * @brief Check that events flooded from several threads are all run, in
+ * the order each thread scheduled them, also when they overflow the
+ * queue of events from other threads.
+ */
+class ThreadedSimulatorFloodTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * @param simulatorType The simulator type.
+     * @param threads The number of threads.
+     * @param events The number of events scheduled by each thread.
+     */
+    ThreadedSimulatorFloodTestCase(const std::string& simulatorType,
+                                   unsigned int threads,
+                                   uint32_t events);
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Flood the simulator with events.
+     * @param threadno The thread number, used as the event context.
+     */
+    void Flood(unsigned int threadno);
+    /**
+     * Check the order of the events of a thread.
+     * @param threadno The thread number.
+     * @param sequence The number of the event within the thread.
+     */
+    void Receive(unsigned int threadno, uint32_t sequence);
+    /** Keep the simulation going until all the events have been run. */
+    void Tick();
+
+    std::string m_simulatorType;      //!< Simulator type.
+    unsigned int m_threads;           //!< The number of threads.
+    uint32_t m_events;                //!< The number of events per thread.
+    std::atomic<bool> m_go;           //!< Start flooding.
+    std::vector<uint32_t> m_next;     //!< Next expected sequence number, by thread.
+    uint64_t m_received;              //!< Number of events run.
+    bool m_outOfOrder;                //!< An event was run out of order.
+    std::vector<std::thread> m_flood; //!< The flooding threads.
+};
+
+ThreadedSimulatorFloodTestCase::ThreadedSimulatorFloodTestCase(const std::string& simulatorType,
+                                                               unsigned int threads,
+                                                               uint32_t events)
+    : TestCase("Check " + std::to_string(threads) + " threads flooding " +
+               std::to_string(events) + " events each in " + simulatorType),
+      m_simulatorType(simulatorType),
+      m_threads(threads),
+      m_events(events)
+{
+}
+
+void
+ThreadedSimulatorFloodTestCase::DoSetup()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(m_simulatorType));
+    m_go = false;
+    m_next.assign(m_threads, 0);
+    m_received = 0;
+    m_outOfOrder = false;
+}
+
+void
+ThreadedSimulatorFloodTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+void
+ThreadedSimulatorFloodTestCase::Flood(unsigned int threadno)
+{
+    while (!m_go)
+    {
+        std::this_thread::yield();
+    }
+    for (uint32_t i = 0; i < m_events; ++i)
+    {
+        Simulator::ScheduleWithContext(threadno,
+                                       Time(0),
+                                       &ThreadedSimulatorFloodTestCase::Receive,
+                                       this,
+                                       threadno,
+                                       i);
+    }
+}
+
+void
+ThreadedSimulatorFloodTestCase::Receive(unsigned int threadno, uint32_t sequence)
+{
+    if (sequence != m_next[threadno] || Simulator::GetContext() != threadno)
+    {
+        m_outOfOrder = true;
+    }
+    m_next[threadno] = sequence + 1;
+    ++m_received;
+}
+
+void
+ThreadedSimulatorFloodTestCase::Tick()
+{
+    if (!m_go)
+    {
+        // the simulation is running: the main thread is known
+        m_go = true;
+    }
+    if (m_received == uint64_t{m_threads} * m_events)
+    {
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(MicroSeconds(10), &ThreadedSimulatorFloodTestCase::Tick, this);
+}
+
+void
+ThreadedSimulatorFloodTestCase::DoRun()
+{
+    Simulator::Schedule(Time(0), &ThreadedSimulatorFloodTestCase::Tick, this);
+    for (unsigned int i = 0; i < m_threads; ++i)
+    {
+        m_flood.emplace_back(&ThreadedSimulatorFloodTestCase::Flood, this, i);
+    }
+
+    Simulator::Run();
+    for (auto& thread : m_flood)
+    {
+        thread.join();
+    }
+    m_flood.clear();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, uint64_t{m_threads} * m_events, "Events lost");
+    NS_TEST_EXPECT_MSG_EQ(m_outOfOrder, false, "Events of one thread run out of order");
+}
+
 /**
  * @ingroup threaded-tests
  *
@@ -287,6 +432,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
             "ns3::HeapScheduler",
             "ns3::MapScheduler",
             "ns3::CalendarScheduler",
+            "ns3::LadderScheduler",
         };
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
@@ -303,6 +449,9 @@ class ThreadedSimulatorTestSuite : public TestSuite
                         TestCase::Duration::QUICK);
                 }
             }
+            // more events than the queue of events from other threads holds
+            AddTestCase(new ThreadedSimulatorFloodTestCase(simulatorType, 4, 20000),
+                        TestCase::Duration::QUICK);
         }
     }
 };
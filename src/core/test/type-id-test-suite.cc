@@ -336,6 +336,90 @@ DeprecatedAttributeTestCase::DoRun()
               << std::endl;
 }
 
+/**
+ * @ingroup typeid-tests
+ *
+ * Class registered by NS_OBJECT_ENSURE_REGISTERED(), and named like its TypeId.
+ */
+class DeferredObject : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::tests::DeferredObject").SetParent<Object>();
+        return tid;
+    }
+
+    double m_padding; //!< Padding, to tell the size from that of Object.
+};
+
+NS_OBJECT_ENSURE_REGISTERED(DeferredObject);
+
+/**
+ * @ingroup typeid-tests
+ *
+ * Class registered by NS_OBJECT_ENSURE_REGISTERED(), and named unlike its TypeId.
+ */
+class DeferredOther : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::tests::DeferredOtherName").SetParent<Object>();
+        return tid;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(DeferredOther);
+
+/**
+ * @ingroup typeid-tests
+ *
+ * Check that the TypeIds whose registration was deferred are found.
+ */
+class DeferredRegistrationTestCase : public TestCase
+{
+  public:
+    DeferredRegistrationTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+DeferredRegistrationTestCase::DeferredRegistrationTestCase()
+    : TestCase("Check deferred TypeId registrations")
+{
+}
+
+void
+DeferredRegistrationTestCase::DoRun()
+{
+    TypeId tid;
+    NS_TEST_ASSERT_MSG_EQ(TypeId::LookupByNameFailSafe("ns3::tests::DeferredObject", &tid),
+                          true,
+                          "lookup by class name");
+    NS_TEST_EXPECT_MSG_EQ(tid, DeferredObject::GetTypeId(), "wrong TypeId");
+    NS_TEST_EXPECT_MSG_EQ(tid.GetSize(), sizeof(DeferredObject), "not registered");
+
+    NS_TEST_ASSERT_MSG_EQ(TypeId::LookupByNameFailSafe("ns3::tests::DeferredOtherName", &tid),
+                          true,
+                          "lookup by other name");
+    NS_TEST_EXPECT_MSG_EQ(tid, DeferredOther::GetTypeId(), "wrong TypeId");
+    NS_TEST_EXPECT_MSG_EQ(tid.GetSize(), sizeof(DeferredOther), "not registered");
+
+    NS_TEST_EXPECT_MSG_EQ(TypeId::LookupByNameFailSafe("ns3::tests::NotRegistered", &tid),
+                          false,
+                          "lookup of a name not registered");
+}
+
 /**
  * @ingroup typeid-tests
  *
@@ -441,6 +525,9 @@ TypeIdTestSuite::TypeIdTestSuite()
     // Turn on logging, so we see the result of collisions
     LogComponentEnable("TypeId", ns3::LogLevel(LOG_ERROR | LOG_PREFIX_FUNC));
 
+    // Before the UniqueTypeIdTestCase, which registers all the
+    // deferred TypeIds.
+    AddTestCase(new DeferredRegistrationTestCase, Duration::QUICK);
     // If the CollisionTestCase is performed before the
     // UniqueIdTestCase, the artificial collisions added by
     // CollisionTestCase will show up in the list of TypeIds
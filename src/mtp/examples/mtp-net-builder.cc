@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-builder.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @file
+ * @ingroup mtp
+ *
+ * Run a NetBuilder grid with the MultithreadedSimulatorImpl, to measure
+ * how the simulation scales with the number of threads.
+ *
+ * Every node sends UDP traffic to another node chosen at random, over
+ * point-to-point links with a delay of 1 ms to 100 ms.  Compare the
+ * wall clock time for several values of \c --threads; \c --threads=0
+ * runs the DefaultSimulatorImpl instead, for reference.
+ *
+ *     ./ns3 run "mtp-net-builder --width=16 --threads=4"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("MtpNetBuilder");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t width = 8;
+    uint32_t threads = 2;
+    double time = 5;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("width", "width of the square grid of nodes", width);
+    cmd.AddValue("threads", "maximum number of threads, 0 for the DefaultSimulatorImpl", threads);
+    cmd.AddValue("time", "simulated time (s)", time);
+    cmd.Parse(argc, argv);
+
+    Ptr<MultithreadedSimulatorImpl> impl;
+    if (threads > 0)
+    {
+        impl = CreateObject<MultithreadedSimulatorImpl>();
+        impl->SetAttribute("MaxThreads", UintegerValue(threads));
+        Simulator::SetImplementation(impl);
+    }
+
+    uint32_t nNodes = width * width;
+    NetBuilder netBuilder(nNodes);
+    netBuilder.quadConnect(width);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    netBuilder.installReceiveAppForAll(Seconds(0), Seconds(time));
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        uint32_t dest = (i + netBuilder.generateRandomInteger(1, nNodes - 1)) % nNodes;
+        netBuilder.installSendApp(i, dest, Seconds(0.1), Seconds(time));
+    }
+
+    Simulator::Stop(Seconds(time));
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t received = 0;
+    NodeContainer nodes = netBuilder.getNodes();
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        for (uint32_t j = 0; j < nodes.Get(i)->GetNApplications(); ++j)
+        {
+            Ptr<PacketSink> sink = DynamicCast<PacketSink>(nodes.Get(i)->GetApplication(j));
+            if (sink)
+            {
+                received += sink->GetTotalRx();
+            }
+        }
+    }
+    uint64_t events = Simulator::GetEventCount();
+
+    std::cout << std::setprecision(4);
+    std::cout << "Nodes:               " << nNodes << std::endl;
+    if (impl)
+    {
+        std::cout << "Partitions:          " << impl->GetPartitionCount() << std::endl;
+        if (impl->GetPartitionCount() > 1)
+        {
+            std::cout << "Lookahead:           " << impl->GetLookahead().As(Time::MS)
+                      << std::endl;
+        }
+    }
+    else
+    {
+        std::cout << "Partitions:          DefaultSimulatorImpl" << std::endl;
+    }
+    std::cout << "Bytes received:      " << received << std::endl;
+    std::cout << "Events:              " << events << std::endl;
+    std::cout << "Wall clock time (s): " << seconds << std::endl;
+    std::cout << "Events per second:   " << events / seconds << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,839 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/type-id.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <utility>
+
+/**
+ * @file
+ * @ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  as in DefaultSimulatorImpl, logging is avoided on the paths
+// taken for every event
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+namespace
+{
+
+/** Time stamp standing for no event at all. */
+constexpr uint64_t NO_EVENT = std::numeric_limits<uint64_t>::max();
+
+} // unnamed namespace
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::g_partition =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "Maximum number of worker threads, one per partition; "
+                          "zero for the number of hardware threads",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MinLookahead",
+                          "Minimum delay of the point-to-point links which may be cut "
+                          "between partitions; the nodes of faster links stay together",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&MultithreadedSimulatorImpl::m_minLookahead),
+                          MakeTimeChecker());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_maxThreads(0),
+      m_lookahead(NO_EVENT),
+      m_windowEnd(0),
+      m_window(0),
+      m_currentTs(0),
+      m_finished(false),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_global.index = 0;
+    m_global.uid = EventId::UID::VALID;
+    m_global.currentUid = EventId::UID::INVALID;
+    m_global.currentTs = 0;
+    m_global.currentContext = Simulator::NO_CONTEXT;
+    m_global.eventCount = 0;
+    m_global.next = NO_EVENT;
+    m_global.sentMin = NO_EVENT;
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    FlushOutboxes();
+    ReceiveForeignEvents(m_currentTs);
+
+    auto clear = [](Partition& partition) {
+        while (partition.events && !partition.events->IsEmpty())
+        {
+            Scheduler::Event next = partition.events->RemoveNext();
+            next.impl->Unref();
+        }
+        partition.events = nullptr;
+    };
+    for (auto& partition : m_partitions)
+    {
+        clear(*partition);
+    }
+    clear(m_global);
+    m_partitions.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    for (;;)
+    {
+        Ptr<EventImpl> ev;
+        {
+            std::unique_lock lock{m_destroyMutex};
+            if (m_destroyEvents.empty())
+            {
+                break;
+            }
+            ev = m_destroyEvents.front().PeekEventImpl();
+            m_destroyEvents.pop_front();
+        }
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ASSERT_MSG(g_partition == nullptr, "Cannot change the scheduler while running");
+    m_schedulerFactory = schedulerFactory;
+
+    auto replace = [&schedulerFactory](Partition& partition) {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        while (partition.events && !partition.events->IsEmpty())
+        {
+            scheduler->Insert(partition.events->RemoveNext());
+        }
+        partition.events = scheduler;
+    };
+    replace(m_global);
+    for (auto& partition : m_partitions)
+    {
+        replace(*partition);
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t nNodes = NodeList::GetNNodes();
+
+    // Union-find of the nodes which must stay in the same partition; the
+    // root of each group is its smallest node id.
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    auto merge = [&parent, &find](uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        parent[std::max(a, b)] = std::min(a, b);
+    };
+
+    // nodes given explicit system ids, as for MPI, keep them
+    bool bySystemId = false;
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        bySystemId = bySystemId || NodeList::GetNode(i)->GetSystemId() != 0;
+    }
+    if (bySystemId)
+    {
+        std::map<uint32_t, uint32_t> systems;
+        for (uint32_t i = 0; i < nNodes; ++i)
+        {
+            auto [system, inserted] = systems.emplace(NodeList::GetNode(i)->GetSystemId(), i);
+            merge(system->second, i);
+        }
+    }
+
+    /** A point-to-point link which may be cut. */
+    struct Link
+    {
+        uint32_t a;     //!< The node at one end.
+        uint32_t b;     //!< The node at the other end.
+        uint64_t delay; //!< The link delay, in time steps.
+    };
+
+    std::vector<Link> links;
+    for (uint32_t c = 0; c < ChannelList::GetNChannels(); ++c)
+    {
+        Ptr<Channel> channel = ChannelList::GetChannel(c);
+        std::size_t nDevices = channel->GetNDevices();
+        if (nDevices == 0)
+        {
+            continue;
+        }
+        uint32_t first = channel->GetDevice(0)->GetNode()->GetId();
+        TimeValue delay;
+        if (nDevices == 2 && channel->GetDevice(0)->IsPointToPoint() &&
+            channel->GetDevice(1)->IsPointToPoint() &&
+            channel->GetAttributeFailSafe("Delay", delay) && delay.Get().IsStrictlyPositive() &&
+            delay.Get() >= m_minLookahead)
+        {
+            links.push_back({first,
+                             channel->GetDevice(1)->GetNode()->GetId(),
+                             static_cast<uint64_t>(delay.Get().GetTimeStep())});
+            continue;
+        }
+        for (std::size_t d = 1; d < nDevices; ++d)
+        {
+            merge(first, channel->GetDevice(d)->GetNode()->GetId());
+        }
+    }
+
+    // Spread the groups, in node id order, over contiguous ranges of
+    // about the same number of nodes
+    std::vector<uint32_t> size(nNodes, 0);
+    uint32_t nGroups = 0;
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        nGroups += find(i) == i ? 1 : 0;
+        size[find(i)]++;
+    }
+    uint32_t nThreads =
+        m_maxThreads > 0 ? m_maxThreads : std::max(1U, std::thread::hardware_concurrency());
+    uint32_t nRanges = std::max(1U, std::min(nThreads, nGroups));
+
+    uint32_t nPartitions = 0;
+    uint32_t lastRange = 0;
+    uint32_t placed = 0;
+    m_partitionOf.assign(nNodes, 0);
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        uint32_t root = find(i);
+        if (root == i)
+        {
+            // a large group may leave some ranges empty
+            uint32_t range = static_cast<uint64_t>(placed) * nRanges / nNodes;
+            if (nPartitions == 0 || range != lastRange)
+            {
+                nPartitions++;
+                lastRange = range;
+            }
+            placed += size[i];
+            m_partitionOf[i] = nPartitions - 1;
+        }
+        else
+        {
+            m_partitionOf[i] = m_partitionOf[root];
+        }
+    }
+    nPartitions = std::max(nPartitions, 1U);
+
+    m_lookahead = NO_EVENT;
+    for (const auto& link : links)
+    {
+        if (m_partitionOf[link.a] != m_partitionOf[link.b])
+        {
+            m_lookahead = std::min(m_lookahead, link.delay);
+        }
+    }
+
+    for (uint32_t p = 0; p < nPartitions; ++p)
+    {
+        auto partition = std::make_unique<Partition>();
+        partition->index = p;
+        partition->events = m_schedulerFactory.Create<Scheduler>();
+        partition->uid = m_global.uid;
+        partition->currentUid = EventId::UID::INVALID;
+        partition->currentTs = m_currentTs;
+        partition->currentContext = Simulator::NO_CONTEXT;
+        partition->eventCount = 0;
+        partition->next = NO_EVENT;
+        partition->sentMin = NO_EVENT;
+        for (auto& outbox : partition->outbox)
+        {
+            outbox.resize(nPartitions + 1);
+        }
+        m_partitions.push_back(std::move(partition));
+    }
+    m_global.index = nPartitions;
+
+    // the events with a context scheduled so far go to their partition,
+    // keeping their uid, and so their order
+    std::vector<Scheduler::Event> global;
+    while (!m_global.events->IsEmpty())
+    {
+        Scheduler::Event ev = m_global.events->RemoveNext();
+        if (ev.key.m_context == Simulator::NO_CONTEXT)
+        {
+            global.push_back(ev);
+        }
+        else
+        {
+            GetOwner(ev.key.m_context).events->Insert(ev);
+        }
+    }
+    for (const auto& ev : global)
+    {
+        m_global.events->Insert(ev);
+    }
+
+    NS_LOG_INFO(nNodes << " nodes in " << nPartitions << " partitions, lookahead "
+                       << GetLookahead().As(Time::S));
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return m_lookahead == NO_EVENT ? Time::Max() : TimeStep(m_lookahead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount() const
+{
+    return m_partitions.size();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition(uint32_t context) const
+{
+    return GetOwner(context).index;
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetOwner(uint32_t context)
+{
+    return const_cast<Partition&>(std::as_const(*this).GetOwner(context));
+}
+
+const MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetOwner(uint32_t context) const
+{
+    if (context == Simulator::NO_CONTEXT || m_partitions.empty())
+    {
+        return m_global;
+    }
+    if (context < m_partitionOf.size())
+    {
+        return *m_partitions[m_partitionOf[context]];
+    }
+    return *m_partitions.front();
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert(Partition& partition,
+                                   uint32_t context,
+                                   uint64_t ts,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = partition.uid;
+    partition.uid++;
+    partition.events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(Partition& partition)
+{
+    Scheduler::Event next = partition.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= partition.currentTs);
+    partition.eventCount++;
+
+    partition.currentTs = next.key.m_ts;
+    partition.currentContext = next.key.m_context;
+    partition.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveEvents(Partition& partition)
+{
+    // the outboxes filled during the previous window
+    auto parity = (m_window + 1) & 1;
+    for (auto& sender : m_partitions)
+    {
+        Outbox& outbox = sender->outbox[parity][partition.index];
+        for (const auto& ev : outbox)
+        {
+            Insert(partition, ev.context, ev.timestamp, ev.event);
+        }
+        outbox.clear();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::FlushOutboxes()
+{
+    for (auto& sender : m_partitions)
+    {
+        for (auto& outboxes : sender->outbox)
+        {
+            for (std::size_t i = 0; i < outboxes.size(); ++i)
+            {
+                Partition& receiver = i < m_partitions.size() ? *m_partitions[i] : m_global;
+                for (const auto& ev : outboxes[i])
+                {
+                    Insert(receiver, ev.context, ev.timestamp, ev.event);
+                }
+                outboxes[i].clear();
+            }
+        }
+        sender->sentMin = NO_EVENT;
+    }
+}
+
+uint64_t
+MultithreadedSimulatorImpl::ReceiveForeignEvents(uint64_t now)
+{
+    std::vector<EventWithContext> events;
+    {
+        std::unique_lock lock{m_foreignMutex};
+        events.swap(m_foreignEvents);
+    }
+    uint64_t next = NO_EVENT;
+    for (const auto& ev : events)
+    {
+        uint64_t ts = now + ev.timestamp;
+        Insert(GetOwner(ev.context), ev.context, ts, ev.event);
+        next = std::min(next, ts);
+    }
+    return next;
+}
+
+void
+MultithreadedSimulatorImpl::WindowCompletion::operator()() noexcept
+{
+    impl->NextWindow();
+}
+
+void
+MultithreadedSimulatorImpl::NextWindow()
+{
+    // the events sent to the global partition, and the next time stamp
+    uint64_t next = NO_EVENT;
+    for (auto& partition : m_partitions)
+    {
+        next = std::min({next, partition->next, partition->sentMin});
+        Outbox& outbox = partition->outbox[m_window & 1][m_global.index];
+        for (const auto& ev : outbox)
+        {
+            Insert(m_global, ev.context, ev.timestamp, ev.event);
+        }
+        outbox.clear();
+    }
+    if (m_stop)
+    {
+        m_finished = true;
+        return;
+    }
+    if (!m_global.events->IsEmpty())
+    {
+        next = std::min(next, m_global.events->PeekNext().key.m_ts);
+    }
+    // the events from other threads are not earlier than any other
+    next = std::min(next, ReceiveForeignEvents(next == NO_EVENT ? m_currentTs : next));
+    if (next == NO_EVENT)
+    {
+        m_finished = true;
+        return;
+    }
+    m_currentTs = next;
+
+    // the global events run alone, on this thread
+    Partition* self = g_partition;
+    g_partition = &m_global;
+    while (!m_global.events->IsEmpty() && m_global.events->PeekNext().key.m_ts == m_currentTs &&
+           !m_stop)
+    {
+        ProcessOneEvent(m_global);
+    }
+    g_partition = self;
+    if (m_stop)
+    {
+        m_finished = true;
+        return;
+    }
+
+    m_windowEnd = m_currentTs + std::min(m_lookahead, NO_EVENT - m_currentTs);
+    if (!m_global.events->IsEmpty())
+    {
+        m_windowEnd = std::min(m_windowEnd, m_global.events->PeekNext().key.m_ts);
+    }
+    m_window++;
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition(uint32_t index)
+{
+    Partition& partition = *m_partitions[index];
+    g_partition = &partition;
+    for (;;)
+    {
+        partition.next =
+            partition.events->IsEmpty() ? NO_EVENT : partition.events->PeekNext().key.m_ts;
+        m_windowBarrier->arrive_and_wait();
+        if (m_finished)
+        {
+            break;
+        }
+        ReceiveEvents(partition);
+        partition.sentMin = NO_EVENT;
+        // a Stop() from a node event ends the window of every partition
+        while (!partition.events->IsEmpty() &&
+               partition.events->PeekNext().key.m_ts < m_windowEnd && !m_stop)
+        {
+            ProcessOneEvent(partition);
+        }
+    }
+    g_partition = nullptr;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    if (!m_global.events->IsEmpty())
+    {
+        return false;
+    }
+    for (const auto& partition : m_partitions)
+    {
+        if (!partition->events->IsEmpty())
+        {
+            return false;
+        }
+        for (const auto& outboxes : partition->outbox)
+        {
+            for (const auto& outbox : outboxes)
+            {
+                if (!outbox.empty())
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    std::unique_lock lock{m_foreignMutex};
+    return m_foreignEvents.empty();
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    if (m_partitions.empty())
+    {
+        CreatePartitions();
+    }
+    ReceiveForeignEvents(m_currentTs);
+    m_stop = false;
+    m_finished = false;
+    // the TypeId registry isn't thread safe: register what is left
+    // before the partitions may create objects
+    TypeId::RegisterDeferred();
+
+    uint32_t nPartitions = m_partitions.size();
+    m_windowBarrier =
+        std::make_unique<std::barrier<WindowCompletion>>(nPartitions, WindowCompletion{this});
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < nPartitions; ++i)
+    {
+        workers.emplace_back(&MultithreadedSimulatorImpl::RunPartition, this, i);
+    }
+    RunPartition(0);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    m_windowBarrier.reset();
+
+    FlushOutboxes();
+    for (const auto& partition : m_partitions)
+    {
+        m_currentTs = std::max(m_currentTs, partition->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    return Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    Partition* partition = g_partition;
+    if (partition == nullptr)
+    {
+        NS_ASSERT_MSG(m_mainThreadId == std::this_thread::get_id(),
+                      "Simulator::Schedule Thread-unsafe invocation!");
+        return Insert(m_global, Simulator::NO_CONTEXT, m_currentTs + delay.GetTimeStep(), event);
+    }
+    return Insert(*partition,
+                  partition->currentContext,
+                  partition->currentTs + delay.GetTimeStep(),
+                  event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    Partition* partition = g_partition;
+    if (partition == nullptr)
+    {
+        if (m_mainThreadId != std::this_thread::get_id())
+        {
+            // Current time added in NextWindow()
+            std::unique_lock lock{m_foreignMutex};
+            m_foreignEvents.push_back({context, static_cast<uint64_t>(delay.GetTimeStep()), event});
+            return;
+        }
+        Insert(GetOwner(context), context, m_currentTs + delay.GetTimeStep(), event);
+        return;
+    }
+
+    uint64_t ts = partition->currentTs + delay.GetTimeStep();
+    Partition& owner = GetOwner(context);
+    if (&owner == partition || partition == &m_global)
+    {
+        // the global events run while the partitions wait
+        Insert(owner, context, ts, event);
+        return;
+    }
+    if (ts < m_windowEnd)
+    {
+        NS_FATAL_ERROR("Event for context " << context << " scheduled from context "
+                                            << partition->currentContext << " at "
+                                            << TimeStep(ts).As(Time::S)
+                                            << ", within the current window ending at "
+                                            << TimeStep(m_windowEnd).As(Time::S)
+                                            << ": events for another partition must be delayed "
+                                               "by at least the lookahead, "
+                                            << GetLookahead().As(Time::S));
+    }
+    partition->outbox[m_window & 1][owner.index].push_back({context, ts, event});
+    partition->sentMin = std::min(partition->sentMin, ts);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false), Now().GetTimeStep(), 0xffffffff, 2);
+    std::unique_lock lock{m_destroyMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    Partition* partition = g_partition;
+    return TimeStep(partition != nullptr ? partition->currentTs : m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs()) - Now();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& owner = GetOwner(id.GetContext());
+    NS_ASSERT_MSG(g_partition == nullptr || g_partition == &owner || g_partition == &m_global,
+                  "Cannot remove an event of another partition");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    owner.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    const Partition& owner = GetOwner(id.GetContext());
+    return id.PeekEventImpl() == nullptr || id.GetTs() < owner.currentTs ||
+           (id.GetTs() == owner.currentTs && id.GetUid() <= owner.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    Partition* partition = g_partition;
+    return partition != nullptr ? partition->currentContext : Simulator::NO_CONTEXT;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = m_global.eventCount;
+    for (const auto& partition : m_partitions)
+    {
+        count += partition->eventCount;
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,310 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <barrier>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+/**
+ * @defgroup mtp Multithreaded Parallel Simulation
+ *
+ * Parallel simulation on the cores of a single host, without MPI.
+ */
+
+/**
+ * @ingroup mtp
+ * @defgroup mtp-tests Multithreaded Parallel Simulation tests
+ */
+
+namespace ns3
+{
+
+// Forward
+class Scheduler;
+
+/**
+ * @ingroup mtp
+ *
+ * @brief A parallel simulator implementation running partitions of the
+ * nodes on the worker threads of a single process.
+ *
+ * At the first Run() the nodes are split into as many partitions as
+ * there are worker threads (the \c MaxThreads attribute), each partition
+ * with its own event queue.  Only point-to-point links with a positive
+ * delay of at least \c MinLookahead are cut; the nodes on any other
+ * channel, and the nodes sharing a non-zero system id, stay together.
+ * Partitions hold contiguous ranges of node ids of about the same size.
+ *
+ * The partitions are synchronised conservatively, in the same way as
+ * the DistributedSimulatorImpl: the lookahead is the smallest delay of
+ * the links between partitions, and all the partitions process the
+ * events earlier than the smallest pending time stamp plus the
+ * lookahead, in parallel, before synchronising on a barrier.  The events
+ * for the nodes of another partition are exchanged through per-thread
+ * queues in memory, and received at the start of the next window.
+ *
+ * Events without a context, such as those scheduled from \c main(), run
+ * on their own, between two windows, while the partitions wait.  They
+ * run before the events of the partitions with the same time stamp.
+ *
+ * Models must only touch the state of the nodes of the partition
+ * running the event, and the events for another node must be delayed
+ * by at least the lookahead: an event that would fall within the
+ * current window is a fatal error.  Trace sinks shared by the nodes of
+ * several partitions must be thread-safe.  Nodes created after the
+ * first Run() belong to the first partition.  ns-3 must be built with
+ * multithreaded simulation support (\c NS3_MTP), which makes the
+ * reference counts of the core and of the packets atomic.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the number of partitions, which is also the number of worker
+     * threads.
+     *
+     * @returns The number of partitions, or zero before the first Run().
+     */
+    uint32_t GetPartitionCount() const;
+    /**
+     * Get the partition running the events of a node.
+     *
+     * @param [in] context The node id.
+     * @returns The partition index.
+     */
+    uint32_t GetPartition(uint32_t context) const;
+    /**
+     * Get the lookahead: the smallest delay of the links between
+     * partitions.
+     *
+     * @returns The lookahead, or Time::Max() with less than two partitions.
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event for another partition, with its absolute time stamp. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event timestamp. */
+        uint64_t timestamp;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /** Container type for the events handed to the other partitions. */
+    typedef std::vector<EventWithContext> Outbox;
+
+    /**
+     * A set of nodes with its own event queue, run by one thread.
+     * Aligned on cache lines, since each is written by its own thread.
+     */
+    struct alignas(64) Partition
+    {
+        /** The partition index; the global events have the last one. */
+        uint32_t index;
+        /** The event priority queue. */
+        Ptr<Scheduler> events;
+        /** Next event unique id. */
+        uint32_t uid;
+        /** Unique id of the current event. */
+        uint32_t currentUid;
+        /** Timestamp of the current event. */
+        uint64_t currentTs;
+        /** Execution context of the current event. */
+        uint32_t currentContext;
+        /** The event count. */
+        uint64_t eventCount;
+        /** Time stamp of the next event, before a window. */
+        uint64_t next;
+        /** Smallest time stamp of the events sent during a window. */
+        uint64_t sentMin;
+        /**
+         * The events for the other partitions, by destination, for the
+         * even and odd windows.  The events sent during a window are
+         * received at the start of the next one, while the partitions
+         * already fill the other outbox.
+         */
+        std::vector<Outbox> outbox[2];
+    };
+
+    /** Synchronisation at the end of a window, choosing the next one. */
+    struct WindowCompletion
+    {
+        /** Choose the next window. */
+        void operator()() noexcept;
+        /** The simulator. */
+        MultithreadedSimulatorImpl* impl;
+    };
+
+    /**
+     * Split the nodes into partitions, compute the lookahead, and move
+     * the node events scheduled so far to their partitions.
+     */
+    void CreatePartitions();
+    /**
+     * Thread body: run the windows of a partition until the end.
+     *
+     * @param [in] index The partition index.
+     */
+    void RunPartition(uint32_t index);
+    /**
+     * Process the next event of a partition.
+     *
+     * @param [in] partition The partition.
+     */
+    void ProcessOneEvent(Partition& partition);
+    /**
+     * Receive the events sent to a partition during the previous window.
+     *
+     * @param [in] partition The partition.
+     */
+    void ReceiveEvents(Partition& partition);
+    /**
+     * Choose the next window, running the global events due at its
+     * start.  Called by the last thread reaching the window barrier.
+     */
+    void NextWindow();
+    /**
+     * Move the events still in the outboxes to their partitions.
+     * Only called while the worker threads are not running.
+     */
+    void FlushOutboxes();
+    /**
+     * Move the events scheduled from other threads to their partitions.
+     *
+     * @param [in] now The time stamp their delay is relative to.
+     * @returns The smallest time stamp of these events.
+     */
+    uint64_t ReceiveForeignEvents(uint64_t now);
+    /**
+     * Insert an event into the event queue of a partition.
+     *
+     * @param [in] partition The partition.
+     * @param [in] context The event context.
+     * @param [in] ts The absolute time stamp.
+     * @param [in] event The event.
+     * @returns The EventId.
+     */
+    EventId Insert(Partition& partition, uint32_t context, uint64_t ts, EventImpl* event);
+    /**
+     * Get the partition running the events of a context.
+     *
+     * @param [in] context The event context.
+     * @returns The partition.
+     */
+    Partition& GetOwner(uint32_t context);
+    /**
+     * Get the partition running the events of a context.
+     *
+     * @param [in] context The event context.
+     * @returns The partition.
+     */
+    const Partition& GetOwner(uint32_t context) const;
+
+    /** The partitions, created at the first Run(). */
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+    /**
+     * The events without a context, and all the events scheduled before
+     * the partitions exist.
+     */
+    Partition m_global;
+    /** The partition of each node, by node id. */
+    std::vector<uint32_t> m_partitionOf;
+    /** The scheduler type. */
+    ObjectFactory m_schedulerFactory;
+    /** Maximum number of worker threads, or zero for the number of cores. */
+    uint32_t m_maxThreads;
+    /** Minimum delay of the links cut between partitions. */
+    Time m_minLookahead;
+    /** Smallest delay of the links between partitions, in time steps. */
+    uint64_t m_lookahead;
+
+    /** Time stamp past the end of the current window. */
+    uint64_t m_windowEnd;
+    /** Number of the current window, selecting the outboxes. */
+    uint64_t m_window;
+    /** Start of the current window, or of the last one after Run(). */
+    uint64_t m_currentTs;
+    /** Flag set by the window barrier when the simulation is over. */
+    bool m_finished;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Barrier ending each window. */
+    std::unique_ptr<std::barrier<WindowCompletion>> m_windowBarrier;
+
+    /** The events scheduled from other threads, with relative time stamps. */
+    std::vector<EventWithContext> m_foreignEvents;
+    /** Mutex to control access to the events from other threads. */
+    mutable std::mutex m_foreignMutex;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex to control access to the destroy events. */
+    mutable std::mutex m_destroyMutex;
+
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+
+    /** The partition whose events the current thread is running, if any. */
+    static thread_local Partition* g_partition;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
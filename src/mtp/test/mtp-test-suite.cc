@@ -0,0 +1,301 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/mac48-address.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * @ingroup mtp-tests
+ *
+ * A ring of nodes forwarding packets to the next node, the packet size
+ * giving the number of hops left.
+ *
+ * The link from node 2 to node 3 is not point-to-point, and the link
+ * from node 6 to node 7 is faster than the lookahead of 1 ms, so that
+ * both must stay within a partition.
+ */
+class MtpRing
+{
+  public:
+    /** The results of a run, by node. */
+    struct Results
+    {
+        std::vector<uint32_t> received; //!< Packets received.
+        std::vector<int64_t> timeSum;   //!< Sum of the receive times (ns).
+        uint64_t events;                //!< Events processed.
+        int64_t end;                    //!< Time at the end of the run (ns).
+    };
+
+    /** Number of nodes in the ring. */
+    static constexpr uint32_t N_NODES = 8;
+
+    /**
+     * Run the ring with a simulator implementation.
+     *
+     * @param [in] impl The simulator implementation.
+     * @returns The results.
+     */
+    Results Run(Ptr<SimulatorImpl> impl);
+
+  private:
+    /** Create the nodes and the links. */
+    void Build();
+    /**
+     * Send a packet to the next node.
+     *
+     * @param [in] node The node index.
+     * @param [in] hops The number of hops left.
+     */
+    void Send(uint32_t node, uint32_t hops);
+    /**
+     * Receive a packet, and forward it if it has hops left.
+     *
+     * @param [in] device The receiving device.
+     * @param [in] packet The packet.
+     * @param [in] protocol The protocol number.
+     * @param [in] from The sender address.
+     * @returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+    /** Start a packet from the main program, between windows. */
+    void Inject();
+
+    NodeContainer m_nodes;                    //!< The nodes.
+    std::vector<Ptr<SimpleNetDevice>> m_next; //!< The device to the next node.
+    Results m_results;                        //!< The results.
+};
+
+void
+MtpRing::Build()
+{
+    m_nodes = NodeContainer();
+    m_nodes.Create(N_NODES);
+    m_next.clear();
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        Time delay = i == 6 ? MicroSeconds(500) : MilliSeconds(1 + i % 3);
+        channel->SetAttribute("Delay", TimeValue(delay));
+        for (uint32_t node : {i, (i + 1) % N_NODES})
+        {
+            Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+            device->SetAttribute("PointToPointMode", BooleanValue(i != 2));
+            device->SetAddress(Mac48Address::Allocate());
+            device->SetChannel(channel);
+            m_nodes.Get(node)->AddDevice(device);
+            // after AddDevice(), which sets the callback of the node
+            device->SetReceiveCallback(MakeCallback(&MtpRing::Receive, this));
+            if (node == i)
+            {
+                m_next.push_back(device);
+            }
+        }
+    }
+}
+
+void
+MtpRing::Send(uint32_t node, uint32_t hops)
+{
+    m_next[node]->Send(Create<Packet>(hops), m_next[node]->GetBroadcast(), 0x800);
+}
+
+bool
+MtpRing::Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from)
+{
+    uint32_t node = device->GetNode()->GetId();
+    m_results.received[node]++;
+    m_results.timeSum[node] += Simulator::Now().GetNanoSeconds();
+    if (packet->GetSize() > 1)
+    {
+        // some processing time on the node, to mix local and remote events
+        Simulator::Schedule(MicroSeconds(10 * node),
+                            &MtpRing::Send,
+                            this,
+                            node,
+                            packet->GetSize() - 1);
+    }
+    return true;
+}
+
+void
+MtpRing::Inject()
+{
+    Simulator::ScheduleWithContext(3, Time(0), &MtpRing::Send, this, 3, 40);
+}
+
+MtpRing::Results
+MtpRing::Run(Ptr<SimulatorImpl> impl)
+{
+    Simulator::Destroy();
+    Simulator::SetImplementation(impl);
+    m_results.received.assign(N_NODES, 0);
+    m_results.timeSum.assign(N_NODES, 0);
+    Build();
+    for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+        for (uint32_t k = 0; k < 5; ++k)
+        {
+            Simulator::ScheduleWithContext(i,
+                                           MilliSeconds(k * (i + 1)),
+                                           &MtpRing::Send,
+                                           this,
+                                           i,
+                                           10 + 7 * k);
+        }
+    }
+    Simulator::Schedule(MilliSeconds(10), &MtpRing::Inject, this);
+    Simulator::Stop(MilliSeconds(70));
+    Simulator::Run();
+    m_results.events = Simulator::GetEventCount();
+    m_results.end = Simulator::Now().GetNanoSeconds();
+    Simulator::Destroy();
+    m_nodes = NodeContainer();
+    m_next.clear();
+    return m_results;
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief Check the split of the nodes into partitions, and the lookahead.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+  public:
+    MtpPartitionTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase()
+    : TestCase("Check the partitions and the lookahead")
+{
+}
+
+void
+MtpPartitionTestCase::DoRun()
+{
+    Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl>();
+    impl->SetAttribute("MaxThreads", UintegerValue(4));
+    impl->SetAttribute("MinLookahead", TimeValue(MilliSeconds(1)));
+    MtpRing ring;
+    ring.Run(impl);
+
+    // groups {0} {1} {2, 3} {4} {5} {6, 7} spread over 4 ranges
+    NS_TEST_ASSERT_MSG_EQ(impl->GetPartitionCount(), 4, "Wrong number of partitions");
+    std::vector<uint32_t> expected = {0, 0, 1, 1, 2, 2, 3, 3};
+    for (uint32_t i = 0; i < MtpRing::N_NODES; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(i), expected[i], "Wrong partition for node " << i);
+    }
+    // links 1-2 (2 ms), 3-4 (1 ms), 5-6 (3 ms) and 7-0 (2 ms) are cut
+    NS_TEST_ASSERT_MSG_EQ(impl->GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+    NS_TEST_ASSERT_MSG_EQ(impl->GetPartition(Simulator::NO_CONTEXT),
+                          4,
+                          "Events without a context should not run in a node partition");
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief Check that the results do not depend on the number of threads,
+ * and are those of the DefaultSimulatorImpl.
+ */
+class MtpEquivalenceTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * @param [in] threads The maximum number of threads.
+     */
+    MtpEquivalenceTestCase(uint32_t threads);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_threads; //!< The maximum number of threads.
+};
+
+MtpEquivalenceTestCase::MtpEquivalenceTestCase(uint32_t threads)
+    : TestCase("Check the results with up to " + std::to_string(threads) + " threads"),
+      m_threads(threads)
+{
+}
+
+void
+MtpEquivalenceTestCase::DoRun()
+{
+    MtpRing ring;
+    ObjectFactory factory("ns3::DefaultSimulatorImpl");
+    MtpRing::Results reference = ring.Run(factory.Create<SimulatorImpl>());
+
+    Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl>();
+    impl->SetAttribute("MaxThreads", UintegerValue(m_threads));
+    MtpRing::Results results = ring.Run(impl);
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(impl->GetPartitionCount(), m_threads, "Too many partitions");
+
+    for (uint32_t i = 0; i < MtpRing::N_NODES; ++i)
+    {
+        NS_TEST_EXPECT_MSG_GT(reference.received[i], 0, "No packet received by node " << i);
+        NS_TEST_EXPECT_MSG_EQ(results.received[i],
+                              reference.received[i],
+                              "Wrong packet count for node " << i);
+        NS_TEST_EXPECT_MSG_EQ(results.timeSum[i],
+                              reference.timeSum[i],
+                              "Wrong receive times for node " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(results.events, reference.events, "Wrong event count");
+    NS_TEST_EXPECT_MSG_EQ(results.end, reference.end, "Wrong time at the end");
+}
+
+/**
+ * @ingroup mtp-tests
+ *
+ * @brief MultithreadedSimulatorImpl TestSuite
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", Type::UNIT)
+{
+    AddTestCase(new MtpPartitionTestCase(), TestCase::Duration::QUICK);
+    for (uint32_t threads : {1, 2, 3, 4})
+    {
+        AddTestCase(new MtpEquivalenceTestCase(threads), TestCase::Duration::QUICK);
+    }
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
@@ -3,26 +3,44 @@
 namespace ns3
 {
 
-std::vector<std::vector<LinkState>> NetBuilder::linkStates;
+LinkStateArrays NetBuilder::linkStates;
 std::map<std::string, int> NetBuilder::ipStrToNodeIndex;
 std::vector<std::vector<std::vector<int>>> NetBuilder::nodeInterfaces;
 
+void
+LinkStateArrays::resize(int nodes)
+{
+    n = nodes;
+    dropCount.assign(n * n, 0);
+    sendCount.assign(n * n, 0);
+    throughput.assign(n * n, 0);
+    bandwidth.assign(n * n, 0);
+    latestSendTime.assign(n * n, 0);
+    delay.assign(n * n, 0);
+}
+
+LinkState
+LinkStateArrays::get(int i, int j) const
+{
+    int k = i * n + j;
+    return {dropCount[k], sendCount[k], throughput[k], bandwidth[k], latestSendTime[k], delay[k]};
+}
+
 void
 NetBuilder::init(int n)
 {
     c.Create(n);
     nodeToIpAddress = std::vector<Ipv4Address>(n);
     adj = std::vector<std::vector<int>>(n, std::vector<int>(n, -1));
+    edges.clear();
     InternetStackHelper internet;
     internet.Install(c);
     networkNumCt = 0;
-    for (int i = 0; i < n; i++)
-    {
-        std::vector<std::vector<int>> v;
-        nodeInterfaces.push_back(v);
-    }
-    linkStates =
-        std::vector<std::vector<LinkState>>(n, std::vector<LinkState>(n, {0, 0, 0, 0, 0, 0}));
+    // the tables below are shared by the static trace callbacks, so a new
+    // topology must not inherit the entries of a previous one
+    nodeInterfaces = std::vector<std::vector<std::vector<int>>>(n);
+    ipStrToNodeIndex.clear();
+    linkStates.resize(n);
 }
 
 int
@@ -37,7 +55,9 @@ NetBuilder::generateRandomInteger(int min, int max)
 std::string
 NetBuilder::getIpBase()
 {
-    return "10.0." + std::to_string(networkNumCt++) + ".0";
+    // one /24 per link: 10.0.0.0, 10.0.1.0, ..., 10.0.255.0, 10.1.0.0, ...
+    int ct = networkNumCt++;
+    return "10." + std::to_string(ct / 256) + "." + std::to_string(ct % 256) + ".0";
 }
 
 std::string
@@ -77,8 +97,8 @@ NetBuilder::simpleConnect(int i, int j)
     // 5Mbps-500Mbps
     int bandwidth = generateRandomInteger(5000000, 500000000);
     p2p.SetDeviceAttribute("DataRate", DataRateValue(bandwidth));
-    linkStates[i][j].bandwidth = bandwidth;
-    linkStates[j][i].bandwidth = bandwidth;
+    linkStates.bandwidth[i * linkStates.n + j] = bandwidth;
+    linkStates.bandwidth[j * linkStates.n + i] = bandwidth;
     // 1ms-100ms
     int delay = generateRandomInteger(1, 100);
     p2p.SetChannelAttribute("Delay", TimeValue(MilliSeconds(delay)));
@@ -112,8 +132,7 @@ NetBuilder::simpleConnect(int i, int j)
 void
 NetBuilder::connect(int i, int j)
 {
-    simpleConnect(i, j);
-    adj[i][j] = adj[j][i] = 1;
+    connect(i, j, 1);
 }
 
 void
@@ -121,6 +140,7 @@ NetBuilder::connect(int i, int j, int w)
 {
     simpleConnect(i, j);
     adj[i][j] = adj[j][i] = w;
+    edges.emplace_back(i, j);
 }
 
 void
@@ -234,6 +254,12 @@ NetBuilder::getAdj()
     return adj;
 }
 
+std::vector<std::pair<int, int>>
+NetBuilder::getEdges()
+{
+    return edges;
+}
+
 void
 NetBuilder::installSendApp(int nodeIndex, int destIndex, Time startTime, Time endTime)
 {
@@ -267,9 +293,17 @@ NetBuilder::TxCallback(int nodeIndex, Ptr<const Packet> pkt, Ptr<Ipv4> ipv4, uin
 {
     int next = getNeighbor(nodeIndex, i);
     // std::cout << "send: " << nodeIndex << " -> " << next << std::endl;
-    linkStates[nodeIndex][next].dropCount++;
-    linkStates[nodeIndex][next].sendCount++;
-    linkStates[nodeIndex][next].latestSendTime = Simulator::Now().GetMicroSeconds();
+    if (next == -1)
+    {
+        return; // not a point-to-point interface (e.g. loopback)
+    }
+    int k = nodeIndex * linkStates.n + next;
+    // the two ends of a link may run on different threads with the
+    // MultithreadedSimulatorImpl
+    std::atomic_ref(linkStates.dropCount[k]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref(linkStates.sendCount[k]).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_ref(linkStates.latestSendTime[k])
+        .store(Simulator::Now().GetMicroSeconds(), std::memory_order_relaxed);
 }
 
 void
@@ -277,10 +311,16 @@ NetBuilder::RxCallback(int nodeIndex, Ptr<const Packet> pkt, Ptr<Ipv4> ipv4, uin
 {
     int pre = getNeighbor(nodeIndex, i);
     // std::cout << "rev: " << pre << " -> " << nodeIndex << std::endl;
-    linkStates[pre][nodeIndex].dropCount--;
-    linkStates[pre][nodeIndex].throughput += pkt->GetSize();
-    int64_t delay = Simulator::Now().GetMicroSeconds() - linkStates[pre][nodeIndex].latestSendTime;
-    linkStates[pre][nodeIndex].delay += delay;
+    if (pre == -1)
+    {
+        return;
+    }
+    int k = pre * linkStates.n + nodeIndex;
+    std::atomic_ref(linkStates.dropCount[k]).fetch_sub(1, std::memory_order_relaxed);
+    linkStates.throughput[k] += pkt->GetSize();
+    int64_t delay = Simulator::Now().GetMicroSeconds() -
+                    std::atomic_ref(linkStates.latestSendTime[k]).load(std::memory_order_relaxed);
+    linkStates.delay[k] += delay;
 }
 
 void
@@ -334,6 +374,21 @@ NetBuilder::installReceiveApp(int nodeIndex)
 
 std::vector<std::vector<LinkState>>
 NetBuilder::getLinkStates()
+{
+    int n = linkStates.n;
+    std::vector<std::vector<LinkState>> result(n, std::vector<LinkState>(n));
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            result[i][j] = linkStates.get(i, j);
+        }
+    }
+    return result;
+}
+
+const LinkStateArrays&
+NetBuilder::getLinkStateArrays()
 {
     return linkStates;
 }
@@ -10,6 +10,7 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 
+#include <atomic>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -36,6 +37,23 @@ struct LinkState
     int64_t delay = 0;          // us
 };
 
+// Link data in structure-of-arrays form: entry i * n + j of every field is
+// the link from node i to node j, so each field is one flat array that can
+// be wrapped without copying (e.g. by NumPy through the Python bindings)
+struct LinkStateArrays
+{
+    int n = 0;
+    std::vector<int> dropCount;
+    std::vector<int> sendCount;
+    std::vector<int> throughput;
+    std::vector<int> bandwidth;
+    std::vector<int64_t> latestSendTime; // us
+    std::vector<int64_t> delay;          // us
+
+    void resize(int nodes);
+    LinkState get(int i, int j) const;
+};
+
 class NetBuilder
 {
   private:
@@ -47,6 +65,8 @@ class NetBuilder
     static std::vector<std::vector<std::vector<int>>> nodeInterfaces;
     // 记录拓扑信息
     std::vector<std::vector<int>> adj;
+    // edges[id] = {i, j}: the id-th link, in connection order
+    std::vector<std::pair<int, int>> edges;
     // not necessary
     Ipv4Address dst;
     // record Ipv4Address on nodes
@@ -56,7 +76,7 @@ class NetBuilder
     Time defaultEndTime = Seconds(10.0);
     uint16_t port = 9;
     // 记录链路数据
-    static std::vector<std::vector<LinkState>> linkStates;
+    static LinkStateArrays linkStates;
 
     void init(int n);
     std::string getIpBase();
@@ -88,6 +108,7 @@ class NetBuilder
     NodeContainer getNodes();
     int generateRandomInteger(int min, int max);
     std::vector<std::vector<int>> getAdj();
+    std::vector<std::pair<int, int>> getEdges();
     void installSendApp(int srcIndex, int destIndex, Time startTime, Time endTime);
     void installSendApp(int srcIndex, int destIndex); // use default start/end time
     void installSendToAllApp(int srcIndex, Time startTime, Time endTime);
@@ -97,6 +118,8 @@ class NetBuilder
     void installReceiveApp(int nodeIndex); // use default start/end time
     void EnableForwardCallback();
     std::vector<std::vector<LinkState>> getLinkStates();
+    // the live link data, without copying; read-only for users
+    static const LinkStateArrays& getLinkStateArrays();
 };
 
 } // namespace ns3
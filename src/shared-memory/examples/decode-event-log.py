@@ -0,0 +1,92 @@
+# -*-  Mode: Python; -*-
+#
+#  SPDX-License-Identifier: GPL-2.0-only
+
+"""
+Decode a control loop event log written by ControlLoopEventLog, e.g.
+
+    ./ns3 run "shared-memory-example --eventLog=rounds.bin"
+    python3 src/shared-memory/examples/decode-event-log.py rounds.bin
+
+Prints one line per record: round, type, simulated and wall clock time and
+the payload (text payloads as is, binary ones in hex), or one CSV row per
+record with --csv.  The log must be decoded on a machine with the same
+byte order as the one that wrote it.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+FILE_HEADER = struct.Struct("=4sHH")
+RECORD_HEADER = struct.Struct("=B3xIqqII")
+MAGIC = b"NSCL"
+VERSION = 1
+TYPES = {1: "sent", 2: "received", 3: "received-binary"}
+
+
+def records(f):
+    """Yield (round, type, sim_ns, wall_ns, payload) for every record of f."""
+    header = f.read(FILE_HEADER.size)
+    if len(header) < FILE_HEADER.size:
+        raise ValueError("file too short")
+    magic, version, _ = FILE_HEADER.unpack(header)
+    if magic != MAGIC:
+        raise ValueError("not a control loop event log")
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+    while True:
+        header = f.read(RECORD_HEADER.size)
+        if not header:
+            return
+        if len(header) < RECORD_HEADER.size:
+            raise ValueError("truncated record header")
+        type_, round_, sim, wall, length, _ = RECORD_HEADER.unpack(header)
+        payload = f.read(length)
+        if len(payload) < length:
+            raise ValueError("truncated payload in round %d" % round_)
+        yield round_, TYPES.get(type_, str(type_)), sim, wall, payload
+
+
+def payload_text(type_, payload):
+    if type_ == "received-binary":
+        return payload.hex()
+    return payload.decode("utf-8", errors="replace")
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Decode a control loop event log")
+    parser.add_argument("log", help="log file written by ControlLoopEventLog")
+    parser.add_argument("--csv", action="store_true", help="write CSV instead of text")
+    parser.add_argument(
+        "--no-payload", action="store_true", help="print payload sizes only"
+    )
+    args = parser.parse_args(argv[1:])
+
+    writer = None
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(["round", "type", "sim_s", "wall_s", "bytes", "payload"])
+
+    with open(args.log, "rb") as f:
+        try:
+            for round_, type_, sim, wall, payload in records(f):
+                text = "" if args.no_payload else payload_text(type_, payload)
+                if writer:
+                    writer.writerow([round_, type_, sim / 1e9, wall / 1e9, len(payload), text])
+                else:
+                    print(
+                        "round %d %s at %.3fs (wall %.6fs), %d bytes"
+                        % (round_, type_, sim / 1e9, wall / 1e9, len(payload))
+                    )
+                    if text:
+                        print(text)
+        except ValueError as e:
+            print("%s: %s" % (args.log, e), file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -23,26 +23,50 @@ void UpdateRouting(std::string data){
 int
 main(int argc, char* argv[])
 {
-    bool verbose = true;
+    bool verbose = false;
+    std::string eventLog;
+    Time stopTime = Seconds(300);
+    Time fastForward = Seconds(0);
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("verbose", "Tell application to log if true", verbose);
+    cmd.AddValue("stopTime", "Simulation stop time", stopTime);
+    cmd.AddValue("eventLog", "Binary file to log every payload to (empty: none)", eventLog);
+    cmd.AddValue("fastForward",
+                 "Run as fast as possible, without real time pacing, until this time",
+                 fastForward);
 
     cmd.Parse(argc, argv);
 
-    LogComponentEnable ("SharedMemorySimulator", LOG_LEVEL_INFO);
+    if (verbose)
+    {
+        LogComponentEnable("SharedMemorySimulator", LOG_LEVEL_INFO);
+        LogComponentEnable("CommunicateWithAIModule", LOG_LEVEL_DEBUG);
+    }
 
     GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
+    if (fastForward.IsStrictlyPositive())
+    {
+        auto impl = DynamicCast<RealtimeSimulatorImpl>(Simulator::GetImplementation());
+        impl->SetPacedWindow(fastForward, stopTime);
+    }
 
     Callback<std::string> CollectCallback = MakeCallback(&CollectNetInfo);
     Callback<void, std::string> UpdateCallback = MakeCallback(&UpdateRouting);
     CommunicateWithAIModule communication(CollectCallback, UpdateCallback);
+    if (!eventLog.empty())
+    {
+        communication.EnableEventLog(eventLog);
+    }
     communication.Start();
 
     NS_LOG_INFO("simulator start");
-    Simulator::Stop(Seconds(300));
+    Simulator::Stop(stopTime);
     Simulator::Run();
     Simulator::Destroy();
     NS_LOG_INFO("simulator end");
+    communication.GetControlLoopProbe()->Print(std::cout);
+    std::cout << "probe overhead: " << ControlLoopProbe::MeasureOverhead(100000).As(Time::NS)
+              << std::endl;
     return 0;
 }
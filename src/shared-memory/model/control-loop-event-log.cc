@@ -0,0 +1,101 @@
+#include "control-loop-event-log.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ControlLoopEventLog");
+
+NS_OBJECT_ENSURE_REGISTERED(ControlLoopEventLog);
+
+TypeId
+ControlLoopEventLog::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ControlLoopEventLog")
+                            .SetParent<Object>()
+                            .SetGroupName("SharedMemory")
+                            .AddConstructor<ControlLoopEventLog>();
+    return tid;
+}
+
+ControlLoopEventLog::ControlLoopEventLog()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ControlLoopEventLog::~ControlLoopEventLog()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+ControlLoopEventLog::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+    Object::DoDispose();
+}
+
+bool
+ControlLoopEventLog::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    Close();
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        NS_LOG_ERROR("cannot open " << filename);
+        return false;
+    }
+    FileHeader header{{'N', 'S', 'C', 'L'}, VERSION, 0};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_opened = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool
+ControlLoopEventLog::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+void
+ControlLoopEventLog::Write(EventType type, uint32_t round, const std::string& payload)
+{
+    NS_LOG_FUNCTION(this << +type << round << payload.size());
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_opened);
+    RecordHeader header{type,
+                        {0, 0, 0},
+                        round,
+                        Simulator::Now().GetNanoSeconds(),
+                        wall.count(),
+                        static_cast<uint32_t>(payload.size()),
+                        0};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(payload.data(), payload.size());
+    if (type != SENT)
+    {
+        // the answer ends a round: keep whole rounds on disk if the run is killed
+        m_file.flush();
+    }
+}
+
+void
+ControlLoopEventLog::Close()
+{
+    if (m_file.is_open())
+    {
+        NS_LOG_FUNCTION(this);
+        m_file.close();
+    }
+}
+
+} // namespace ns3
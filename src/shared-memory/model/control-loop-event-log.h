@@ -0,0 +1,100 @@
+#ifndef CONTROL_LOOP_EVENT_LOG_H
+#define CONTROL_LOOP_EVENT_LOG_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @ingroup shared-memory
+ *
+ * Binary log of the payloads exchanged by the CommunicateWithAIModule
+ * control loop, one record per payload, for offline decoding with
+ * src/shared-memory/examples/decode-event-log.py.
+ *
+ * This replaces printing every payload to stdout: the records are
+ * written through a buffered stream and are not formatted at run time.
+ *
+ * The file starts with a FileHeader, followed by records made of a
+ * RecordHeader and \c length payload bytes.  All fields are in host
+ * byte order.
+ */
+class ControlLoopEventLog : public Object
+{
+  public:
+    /** Record types. */
+    enum EventType : uint8_t
+    {
+        SENT = 1,            //!< Network information written for the agent
+        RECEIVED_TEXT = 2,   //!< Text answer ("ns" mode) of the agent
+        RECEIVED_BINARY = 3, //!< Binary answer ("nb" mode) of the agent
+    };
+
+    /** Start of the file. */
+    struct FileHeader
+    {
+        char magic[4];    //!< "NSCL"
+        uint16_t version; //!< VERSION
+        uint16_t reserved;
+    };
+
+    /** Start of every record. */
+    struct RecordHeader
+    {
+        uint8_t type; //!< EventType
+        uint8_t reserved[3];
+        uint32_t round;   //!< Control loop round
+        int64_t simTime;  //!< Simulated time (ns)
+        int64_t wallTime; //!< Wall clock time since Open (ns)
+        uint32_t length;  //!< Payload bytes that follow
+        uint32_t reserved2;
+    };
+
+    /** Current file format version. */
+    static const uint16_t VERSION = 1;
+
+    /**
+     * Register this type.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    ControlLoopEventLog();
+    ~ControlLoopEventLog() override;
+
+    /**
+     * Create (or truncate) the log file and write the file header.
+     * @param [in] filename The file name.
+     * @return true if the file could be opened.
+     */
+    bool Open(const std::string& filename);
+    /** @return true if the log is open. */
+    bool IsOpen() const;
+    /**
+     * Append one record; does nothing if the log is not open.  The file
+     * is flushed after every received record, i.e. once per round.
+     * @param [in] type The record type.
+     * @param [in] round The control loop round.
+     * @param [in] payload The payload.
+     */
+    void Write(EventType type, uint32_t round, const std::string& payload);
+    /** Flush and close the file. */
+    void Close();
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    std::ofstream m_file;                           //!< Log file
+    std::chrono::steady_clock::time_point m_opened; //!< Wall clock time of Open
+};
+
+} // namespace ns3
+
+#endif // CONTROL_LOOP_EVENT_LOG_H
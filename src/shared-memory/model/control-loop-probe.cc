@@ -0,0 +1,214 @@
+#include "control-loop-probe.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <iomanip>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ControlLoopProbe");
+
+NS_OBJECT_ENSURE_REGISTERED(ControlLoopProbe);
+
+namespace
+{
+
+/**
+ * @param [in] start The start time point.
+ * @return The wall clock time since \p start.
+ */
+Time
+WallSince(std::chrono::steady_clock::time_point start)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    return NanoSeconds(ns.count());
+}
+
+} // namespace
+
+TypeId
+ControlLoopProbe::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ControlLoopProbe")
+            .SetParent<Object>()
+            .SetGroupName("SharedMemory")
+            .AddConstructor<ControlLoopProbe>()
+            .AddAttribute("HistogramBinWidth",
+                          "Width of the per-round histogram bins, in microseconds.",
+                          DoubleValue(100),
+                          MakeDoubleAccessor(&ControlLoopProbe::m_binWidth),
+                          MakeDoubleChecker<double>(0))
+            .AddTraceSource("Stage",
+                            "One stage of the control loop has been measured.",
+                            MakeTraceSourceAccessor(&ControlLoopProbe::m_stageTrace),
+                            "ns3::ControlLoopProbe::StageTracedCallback")
+            .AddTraceSource("RoundEnd",
+                            "A control loop round has ended.",
+                            MakeTraceSourceAccessor(&ControlLoopProbe::m_roundTrace),
+                            "ns3::ControlLoopProbe::RoundTracedCallback");
+    return tid;
+}
+
+ControlLoopProbe::ControlLoopProbe()
+    : m_round(0),
+      m_inRound(false),
+      m_binWidth(100)
+{
+    NS_LOG_FUNCTION(this);
+    m_roundWall.fill(Time(0));
+    m_totalWall.fill(Time(0));
+}
+
+void
+ControlLoopProbe::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Object::DoDispose();
+}
+
+std::string
+ControlLoopProbe::GetStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case COLLECT_NET_INFO:
+        return "CollectNetInfo";
+    case WRITE_SHARED_MEMORY:
+        return "WriteSharedMemory";
+    case LISTEN:
+        return "Listen";
+    case UPDATE_ROUTING:
+        return "UpdateRouting";
+    case UPDATE_WEIGHTS:
+        return "UpdateWeights";
+    case ROUTE_INSTALL:
+        return "RouteInstall";
+    case ROUND:
+        return "Round";
+    default:
+        return "Unknown";
+    }
+}
+
+void
+ControlLoopProbe::BeginRound()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_inRound)
+    {
+        EndRound();
+    }
+    ++m_round;
+    m_inRound = true;
+    m_roundWall.fill(Time(0));
+    m_roundWallStart = std::chrono::steady_clock::now();
+    m_roundSimStart = Simulator::Now();
+}
+
+void
+ControlLoopProbe::EndRound()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_inRound)
+    {
+        return;
+    }
+    Record(ROUND, WallSince(m_roundWallStart), Simulator::Now() - m_roundSimStart);
+    m_inRound = false;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        if (m_histograms[stage].GetNBins() == 0)
+        {
+            m_histograms[stage].SetDefaultBinWidth(m_binWidth);
+        }
+        m_histograms[stage].AddValue(m_roundWall[stage].GetMicroSeconds());
+    }
+    NS_LOG_INFO("round " << m_round << " took " << m_roundWall[ROUND].As(Time::US));
+    m_roundTrace(m_round, m_roundWall);
+}
+
+void
+ControlLoopProbe::Record(Stage stage, Time wall, Time sim)
+{
+    NS_LOG_FUNCTION(this << GetStageName(stage) << wall << sim);
+    m_roundWall[stage] += wall;
+    m_totalWall[stage] += wall;
+    m_stageTrace(m_round, stage, wall, sim);
+}
+
+uint32_t
+ControlLoopProbe::GetRound() const
+{
+    return m_round;
+}
+
+const Histogram&
+ControlLoopProbe::GetHistogram(Stage stage) const
+{
+    NS_ASSERT(stage < STAGE_COUNT);
+    return m_histograms[stage];
+}
+
+Time
+ControlLoopProbe::GetTotal(Stage stage) const
+{
+    NS_ASSERT(stage < STAGE_COUNT);
+    return m_totalWall[stage];
+}
+
+void
+ControlLoopProbe::Print(std::ostream& os) const
+{
+    uint32_t rounds = m_inRound ? m_round - 1 : m_round;
+    os << "control loop: " << rounds << " rounds" << std::endl;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        Time total = m_totalWall[stage];
+        os << "  " << std::left << std::setw(18) << GetStageName(Stage(stage)) << " total "
+           << total.As(Time::US);
+        if (rounds > 0)
+        {
+            os << ", mean " << (total / rounds).As(Time::US);
+        }
+        os << std::endl;
+    }
+}
+
+Time
+ControlLoopProbe::MeasureOverhead(uint32_t n)
+{
+    if (n == 0)
+    {
+        return Time(0);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Scope scope(nullptr, COLLECT_NET_INFO);
+    }
+    return WallSince(start) / n;
+}
+
+ControlLoopProbe::Scope::Scope(Ptr<ControlLoopProbe> probe, Stage stage)
+    : m_probe(probe),
+      m_stage(stage),
+      m_wallStart(std::chrono::steady_clock::now()),
+      m_simStart(Simulator::Now())
+{
+}
+
+ControlLoopProbe::Scope::~Scope()
+{
+    Time wall = WallSince(m_wallStart);
+    if (m_probe)
+    {
+        m_probe->Record(m_stage, wall, Simulator::Now() - m_simStart);
+    }
+}
+
+} // namespace ns3
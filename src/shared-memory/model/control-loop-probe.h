@@ -0,0 +1,193 @@
+#ifndef CONTROL_LOOP_PROBE_H
+#define CONTROL_LOOP_PROBE_H
+
+#include "ns3/histogram.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @ingroup shared-memory
+ *
+ * Timing probes for one agent round of the CommunicateWithAIModule /
+ * CentralController control loop.
+ *
+ * A round starts when CommunicateWithAIModule collects the network
+ * information and ends when the routing update returned by the agent has
+ * been installed.  Every stage of the round records its wall clock time
+ * and the simulated time that elapsed while it ran (only Listen spans
+ * simulated time, as it polls the control block every 50 ms).
+ *
+ * At the end of a round the per-stage wall times are added to one
+ * Histogram per stage and reported through the RoundEnd trace source;
+ * every single measurement is reported through the Stage trace source.
+ *
+ * The probes are compiled in when ns-3 is configured with
+ * NS3_CONTROL_LOOP_PROBES=ON (the default); otherwise the
+ * NS_CONTROL_LOOP_PROBE macro expands to nothing.
+ */
+class ControlLoopProbe : public Object
+{
+  public:
+    /** The stages of one round. */
+    enum Stage
+    {
+        COLLECT_NET_INFO = 0, //!< CollectNetInfo callback (string building)
+        WRITE_SHARED_MEMORY,  //!< Copy of the payload and header to shared memory
+        LISTEN,               //!< Polling the control block for the answer
+        UPDATE_ROUTING,       //!< Whole UpdateRouting callback
+        UPDATE_WEIGHTS,       //!< CentralController weight parsing
+        ROUTE_INSTALL,        //!< CentralController route computation and installation
+        ROUND,                //!< Whole round, from collection to installed routes
+        STAGE_COUNT           //!< Number of stages
+    };
+
+    /** Per-stage wall clock times of one round. */
+    typedef std::array<Time, STAGE_COUNT> RoundTimes;
+
+    /**
+     * TracedCallback signature for a single stage measurement.
+     *
+     * @param [in] round The round index.
+     * @param [in] stage The stage.
+     * @param [in] wall The wall clock time spent in the stage.
+     * @param [in] sim The simulated time spent in the stage.
+     */
+    typedef void (*StageTracedCallback)(uint32_t round, Stage stage, Time wall, Time sim);
+
+    /**
+     * TracedCallback signature for the end of a round.
+     *
+     * @param [in] round The round index.
+     * @param [in] wall The wall clock time spent in each stage during the round.
+     */
+    typedef void (*RoundTracedCallback)(uint32_t round, const RoundTimes& wall);
+
+    /**
+     * Register this type.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    ControlLoopProbe();
+
+    /**
+     * @param [in] stage The stage.
+     * @return The printable name of the stage.
+     */
+    static std::string GetStageName(Stage stage);
+
+    /** Start a new round: resets the per-round accumulators. */
+    void BeginRound();
+    /** End the current round: fills the histograms and fires RoundEnd. */
+    void EndRound();
+
+    /**
+     * Record one measurement of a stage.
+     *
+     * A stage may be recorded several times per round (Listen is recorded
+     * once per poll); the round totals are the sums.
+     *
+     * @param [in] stage The stage.
+     * @param [in] wall The wall clock time spent.
+     * @param [in] sim The simulated time spent.
+     */
+    void Record(Stage stage, Time wall, Time sim);
+
+    /** @return The index of the current (or last) round. */
+    uint32_t GetRound() const;
+
+    /**
+     * @param [in] stage The stage.
+     * @return The histogram of the per-round wall time of \p stage, in microseconds.
+     */
+    const Histogram& GetHistogram(Stage stage) const;
+
+    /**
+     * @param [in] stage The stage.
+     * @return The total wall clock time of \p stage over all rounds.
+     */
+    Time GetTotal(Stage stage) const;
+
+    /**
+     * Print the per-stage totals and means over all completed rounds.
+     *
+     * @param [in] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * Measure the cost of one probe, by timing \p n scoped measurements
+     * that are not recorded.
+     *
+     * @param [in] n The number of measurements.
+     * @return The mean wall clock overhead of one probe.
+     */
+    static Time MeasureOverhead(uint32_t n);
+
+    /**
+     * RAII measurement of one stage: records the wall clock and simulated
+     * time between construction and destruction.  A null probe is ignored.
+     */
+    class Scope
+    {
+      public:
+        /**
+         * Start measuring.
+         * @param [in] probe The probe to record into, may be null.
+         * @param [in] stage The stage being measured.
+         */
+        Scope(Ptr<ControlLoopProbe> probe, Stage stage);
+        /** Stop measuring and record. */
+        ~Scope();
+
+      private:
+        Ptr<ControlLoopProbe> m_probe;                      //!< Probe to record into
+        Stage m_stage;                                      //!< Stage being measured
+        std::chrono::steady_clock::time_point m_wallStart; //!< Wall clock start
+        Time m_simStart;                                    //!< Simulated start
+    };
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    uint32_t m_round;                                //!< Current round index
+    bool m_inRound;                                  //!< A round is in progress
+    double m_binWidth;                               //!< Histogram bin width (us)
+    RoundTimes m_roundWall;                          //!< Wall times of the current round
+    RoundTimes m_totalWall;                          //!< Wall times over all rounds
+    std::array<Histogram, STAGE_COUNT> m_histograms; //!< Per-round wall time histograms
+    std::chrono::steady_clock::time_point m_roundWallStart; //!< Wall clock start of the round
+    Time m_roundSimStart;                                   //!< Simulated start of the round
+
+    /** Trace fired for every stage measurement. */
+    TracedCallback<uint32_t, Stage, Time, Time> m_stageTrace;
+    /** Trace fired at the end of every round. */
+    TracedCallback<uint32_t, const RoundTimes&> m_roundTrace;
+};
+
+} // namespace ns3
+
+#ifdef ENABLE_CONTROL_LOOP_PROBES
+/**
+ * @ingroup shared-memory
+ * Measure the rest of the enclosing block as \p stage of \p probe.
+ *
+ * @param [in] probe Ptr<ControlLoopProbe>, may be null.
+ * @param [in] stage The ControlLoopProbe::Stage.
+ */
+#define NS_CONTROL_LOOP_PROBE(probe, stage)                                                        \
+    ns3::ControlLoopProbe::Scope controlLoopProbeScope(probe, ns3::ControlLoopProbe::stage)
+#else
+#define NS_CONTROL_LOOP_PROBE(probe, stage)
+#endif
+
+#endif // CONTROL_LOOP_PROBE_H
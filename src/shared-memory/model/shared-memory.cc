@@ -3,6 +3,8 @@
 namespace ns3
 {
 
+NS_LOG_COMPONENT_DEFINE("CommunicateWithAIModule");
+
 int CommunicateWithAIModule::createOrOpenSharedMemory(BlockInfo& info){
   int fd = shm_open(info.name, O_CREAT | O_RDWR, 0666);
   if (fd == -1) {
@@ -42,6 +44,7 @@ CommunicateWithAIModule::CommunicateWithAIModule(
   Callback<std::string> collectNetInfo, 
   Callback<void, std::string> updateRouting
 ): CollectNetInfo(collectNetInfo), UpdateRouting(updateRouting){
+  probe = CreateObject<ControlLoopProbe>();
   // open shared memory of data block
   dataBlockInfo = { -1,  DATA_BLOCK_SIZE, "", DATA_BLOCK_NAME};
   if(createOrOpenSharedMemory(dataBlockInfo) != 0){
@@ -52,11 +55,14 @@ CommunicateWithAIModule::CommunicateWithAIModule(
   if(createOrOpenSharedMemory(ctrlBlockInfo) != 0){
     return;
   }
-  printf("memory ready\n");
+  NS_LOG_INFO("memory ready");
 }
 
 CommunicateWithAIModule::~CommunicateWithAIModule(){
-  std::cout << "~CommunicateWithAIModule" << std::endl;
+  NS_LOG_FUNCTION(this);
+  if(eventLog){
+    eventLog->Dispose();
+  }
   freeSharedMemory(ctrlBlockInfo);
   freeSharedMemory(dataBlockInfo);
 }
@@ -70,6 +76,17 @@ std::string CommunicateWithAIModule::readSharedMemory(BlockInfo info, int len){
   return getSubstring(info.sharedMemory, len);
 }
 
+std::string CommunicateWithAIModule::readSharedMemoryRaw(BlockInfo info, int len){
+  if (info.sharedMemory == MAP_FAILED) {
+    std::cout<< "read shm_open err: " << info.name << std::endl;
+    close(info.fd);
+    return "";
+  }
+  // binary data may contain '\0', so do not stop at the first one
+  len = (len < info.size)? len : info.size;
+  return std::string(info.sharedMemory, len);
+}
+
 std::string CommunicateWithAIModule::getSubstring(const char* str, int n) {
   if (str == nullptr) {
     return "";
@@ -124,12 +141,33 @@ int extractNumberAfterSlash(const std::string& input) {
 }
 
 void CommunicateWithAIModule::Listen(){
-  std::string modSlashLen = readSharedMemory(ctrlBlockInfo, 11); // ns/00000013
+  std::string modSlashLen;
+  {
+    NS_CONTROL_LOOP_PROBE(probe, LISTEN);
+    modSlashLen = readSharedMemory(ctrlBlockInfo, 11); // ns/00000013
+  }
   std::string mod = modSlashLen.substr(0, 2);
-  if(mod == "ns"){
+  // "ns": text payload, "nb": binary payload of exactly len bytes
+  if(mod == "ns" || mod == "nb"){
+#ifdef ENABLE_CONTROL_LOOP_PROBES
+    // the polls above only take wall time, the wait itself is simulated time
+    probe->Record(ControlLoopProbe::LISTEN, Time(0), Simulator::Now() - listenStart);
+#endif
     int len = extractNumberAfterSlash(modSlashLen);
-    std::string data = readSharedMemory(dataBlockInfo, len);
-    UpdateRouting(data);
+    std::string data = mod == "nb" ? readSharedMemoryRaw(dataBlockInfo, len)
+                                   : readSharedMemory(dataBlockInfo, len);
+    NS_LOG_DEBUG("read: " << (mod == "nb" ? "<" + std::to_string(len) + " bytes>" : data));
+    if(eventLog){
+      eventLog->Write(mod == "nb" ? ControlLoopEventLog::RECEIVED_BINARY
+                                  : ControlLoopEventLog::RECEIVED_TEXT, round, data);
+    }
+    {
+      NS_CONTROL_LOOP_PROBE(probe, UPDATE_ROUTING);
+      UpdateRouting(data);
+    }
+#ifdef ENABLE_CONTROL_LOOP_PROBES
+    probe->EndRound();
+#endif
     Simulator::Schedule(Seconds(duration), &CommunicateWithAIModule::CollectAndSend, this);
   }else{
     Simulator::Schedule(MilliSeconds(50), &CommunicateWithAIModule::Listen, this);
@@ -138,9 +176,24 @@ void CommunicateWithAIModule::Listen(){
 
 void CommunicateWithAIModule::CollectAndSend(){
   if(!CollectNetInfo.IsNull()){
-    std::string data = CollectNetInfo();
-    writeSharedMemory(dataBlockInfo.sharedMemory, data);
-    writeSharedMemory(ctrlBlockInfo.sharedMemory, getPaddedMod(data, "ai"));
+#ifdef ENABLE_CONTROL_LOOP_PROBES
+    probe->BeginRound();
+#endif
+    std::string data;
+    {
+      NS_CONTROL_LOOP_PROBE(probe, COLLECT_NET_INFO);
+      data = CollectNetInfo();
+    }
+    round++;
+    if(eventLog){
+      eventLog->Write(ControlLoopEventLog::SENT, round, data);
+    }
+    {
+      NS_CONTROL_LOOP_PROBE(probe, WRITE_SHARED_MEMORY);
+      writeSharedMemory(dataBlockInfo.sharedMemory, data);
+      writeSharedMemory(ctrlBlockInfo.sharedMemory, getPaddedMod(data, "ai"));
+    }
+    listenStart = Simulator::Now();
     Simulator::Schedule(MilliSeconds(50), &CommunicateWithAIModule::Listen, this);
   }else{
     printf("CollectNetInfo.IsNull\n");
@@ -151,8 +204,19 @@ void CommunicateWithAIModule::Start(){
   Simulator::Schedule(Seconds(duration), &CommunicateWithAIModule::CollectAndSend, this);
 }
 
+Ptr<ControlLoopProbe> CommunicateWithAIModule::GetControlLoopProbe() const{
+  return probe;
+}
+
+bool CommunicateWithAIModule::EnableEventLog(std::string filename){
+  if(!eventLog){
+    eventLog = CreateObject<ControlLoopEventLog>();
+  }
+  return eventLog->Open(filename);
+}
+
 void CommunicateWithAIModule::writeSharedMemory(char* shm, std::string data){
-  std::cout<<"write: "<<data<<std::endl;
+  NS_LOG_DEBUG("write: " << data);
   for(int i=0; i<data.length(); i++){
     shm[i] = data[i];
   }
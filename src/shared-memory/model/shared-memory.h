@@ -10,6 +10,8 @@
 #include <iomanip>
 #include <sstream>
 #include "ns3/core-module.h"
+#include "ns3/control-loop-event-log.h"
+#include "ns3/control-loop-probe.h"
 // Add a doxygen group for this module.
 // If you have more than one file, this should be in only one of them.
 /**
@@ -39,10 +41,15 @@ private:
   BlockInfo ctrlBlockInfo;
   Callback<std::string> CollectNetInfo;
   Callback<void, std::string> UpdateRouting;
+  Ptr<ControlLoopProbe> probe;
+  Time listenStart; // simulated time when polling for the answer began
+  Ptr<ControlLoopEventLog> eventLog;
+  uint32_t round = 0;
 
   int createOrOpenSharedMemory(BlockInfo& info);
   void freeSharedMemory(BlockInfo info);
   std::string readSharedMemory(BlockInfo info, int len);
+  std::string readSharedMemoryRaw(BlockInfo info, int len);
   void CollectAndSend();
   void Listen();
   std::string getSubstring(const char* str, int n);
@@ -52,6 +59,10 @@ public:
   CommunicateWithAIModule(Callback<std::string> CollectNetInfo, Callback<void, std::string> UpdateRouting);
   ~CommunicateWithAIModule();
   void Start();
+  // timing probes of the collect/send/listen/update rounds
+  Ptr<ControlLoopProbe> GetControlLoopProbe() const;
+  // log every payload sent and received to a binary file, see ControlLoopEventLog
+  bool EnableEventLog(std::string filename);
 };
 
 } // namespace ns3
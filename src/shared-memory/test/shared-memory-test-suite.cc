@@ -1,4 +1,6 @@
 // Include a header file from your module to test.
+#include "ns3/control-loop-event-log.h"
+#include "ns3/control-loop-probe.h"
 #include "ns3/shared-memory.h"
 
 // An essential include is test.h
@@ -56,6 +58,158 @@ SharedMemoryTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * @ingroup shared-memory-tests
+ * Check that ControlLoopProbe sums the stages of a round, fills the
+ * per-round histograms and fires its trace sources.
+ */
+class ControlLoopProbeTestCase : public TestCase
+{
+  public:
+    ControlLoopProbeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Stage trace sink.
+     * @param round The round index.
+     * @param stage The stage.
+     * @param wall The wall clock time.
+     * @param sim The simulated time.
+     */
+    void Stage(uint32_t round, ControlLoopProbe::Stage stage, Time wall, Time sim);
+    /**
+     * RoundEnd trace sink.
+     * @param round The round index.
+     * @param wall The per-stage wall clock times.
+     */
+    void RoundEnd(uint32_t round, const ControlLoopProbe::RoundTimes& wall);
+
+    uint32_t m_stages{0};                //!< Number of Stage traces
+    uint32_t m_rounds{0};                //!< Number of RoundEnd traces
+    ControlLoopProbe::RoundTimes m_last; //!< Last RoundEnd times
+};
+
+ControlLoopProbeTestCase::ControlLoopProbeTestCase()
+    : TestCase("ControlLoopProbe round accounting")
+{
+}
+
+void
+ControlLoopProbeTestCase::Stage(uint32_t round, ControlLoopProbe::Stage stage, Time wall, Time sim)
+{
+    m_stages++;
+}
+
+void
+ControlLoopProbeTestCase::RoundEnd(uint32_t round, const ControlLoopProbe::RoundTimes& wall)
+{
+    m_rounds++;
+    m_last = wall;
+}
+
+void
+ControlLoopProbeTestCase::DoRun()
+{
+    Ptr<ControlLoopProbe> probe = CreateObject<ControlLoopProbe>();
+    probe->TraceConnectWithoutContext("Stage",
+                                      MakeCallback(&ControlLoopProbeTestCase::Stage, this));
+    probe->TraceConnectWithoutContext("RoundEnd",
+                                      MakeCallback(&ControlLoopProbeTestCase::RoundEnd, this));
+
+    probe->BeginRound();
+    probe->Record(ControlLoopProbe::LISTEN, MicroSeconds(10), MilliSeconds(50));
+    probe->Record(ControlLoopProbe::LISTEN, MicroSeconds(20), MilliSeconds(50));
+    probe->Record(ControlLoopProbe::UPDATE_WEIGHTS, MicroSeconds(250), Time(0));
+    probe->EndRound();
+
+    NS_TEST_ASSERT_MSG_EQ(probe->GetRound(), 1, "one round started");
+    NS_TEST_ASSERT_MSG_EQ(m_rounds, 1, "RoundEnd fired once");
+    // two LISTEN, one UPDATE_WEIGHTS and the ROUND itself
+    NS_TEST_ASSERT_MSG_EQ(m_stages, 4, "Stage fired for every measurement");
+    NS_TEST_ASSERT_MSG_EQ(m_last[ControlLoopProbe::LISTEN],
+                          MicroSeconds(30),
+                          "polls of a round are summed");
+    NS_TEST_ASSERT_MSG_EQ(m_last[ControlLoopProbe::COLLECT_NET_INFO],
+                          Time(0),
+                          "unmeasured stages are zero");
+
+    // a second round without closing the first one closes it implicitly
+    probe->BeginRound();
+    probe->Record(ControlLoopProbe::LISTEN, MicroSeconds(5), Time(0));
+    probe->BeginRound();
+    NS_TEST_ASSERT_MSG_EQ(m_rounds, 2, "BeginRound ends an open round");
+    NS_TEST_ASSERT_MSG_EQ(probe->GetTotal(ControlLoopProbe::LISTEN),
+                          MicroSeconds(35),
+                          "totals span all rounds");
+
+    const Histogram& histogram = probe->GetHistogram(ControlLoopProbe::UPDATE_WEIGHTS);
+    uint32_t samples = 0;
+    for (uint32_t i = 0; i < histogram.GetNBins(); ++i)
+    {
+        samples += histogram.GetBinCount(i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(samples, 2, "one histogram sample per stage per round");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetBinCount(2), 1, "250 us falls in the third 100 us bin");
+
+    probe->Dispose();
+}
+
+/**
+ * @ingroup shared-memory-tests
+ * Check the file layout written by ControlLoopEventLog.
+ */
+class ControlLoopEventLogTestCase : public TestCase
+{
+  public:
+    ControlLoopEventLogTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ControlLoopEventLogTestCase::ControlLoopEventLogTestCase()
+    : TestCase("ControlLoopEventLog file layout")
+{
+}
+
+void
+ControlLoopEventLogTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("control-loop-events.bin");
+    Ptr<ControlLoopEventLog> log = CreateObject<ControlLoopEventLog>();
+    log->Write(ControlLoopEventLog::SENT, 0, "dropped, the log is not open");
+    NS_TEST_ASSERT_MSG_EQ(log->Open(filename), true, "cannot open " << filename);
+    log->Write(ControlLoopEventLog::SENT, 1, "0 1 2/");
+    log->Write(ControlLoopEventLog::RECEIVED_BINARY, 1, std::string("\x01\0\0\0", 4));
+    log->Dispose();
+    NS_TEST_ASSERT_MSG_EQ(log->IsOpen(), false, "Dispose closes the log");
+
+    std::ifstream file(filename, std::ios::binary);
+    ControlLoopEventLog::FileHeader fileHeader;
+    file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+    NS_TEST_ASSERT_MSG_EQ(std::string(fileHeader.magic, 4), "NSCL", "magic");
+    NS_TEST_ASSERT_MSG_EQ(fileHeader.version, ControlLoopEventLog::VERSION, "version");
+
+    ControlLoopEventLog::RecordHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    NS_TEST_ASSERT_MSG_EQ(+header.type, +ControlLoopEventLog::SENT, "first record type");
+    NS_TEST_ASSERT_MSG_EQ(header.round, 1, "first record round");
+    NS_TEST_ASSERT_MSG_EQ(header.length, 6, "first record length");
+    std::string payload(header.length, '\0');
+    file.read(payload.data(), payload.size());
+    NS_TEST_ASSERT_MSG_EQ(payload, "0 1 2/", "first record payload");
+
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    NS_TEST_ASSERT_MSG_EQ(+header.type,
+                          +ControlLoopEventLog::RECEIVED_BINARY,
+                          "second record type");
+    NS_TEST_ASSERT_MSG_EQ(header.length, 4, "binary payloads keep their zero bytes");
+    file.seekg(header.length, std::ios::cur);
+    NS_TEST_ASSERT_MSG_EQ(file.peek(), std::ifstream::traits_type::eof(), "two records");
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -75,6 +229,8 @@ SharedMemoryTestSuite::SharedMemoryTestSuite()
 {
     // Duration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new SharedMemoryTestCase1, TestCase::Duration::QUICK);
+    AddTestCase(new ControlLoopProbeTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new ControlLoopEventLogTestCase, TestCase::Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,320 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/central-controller.h"
+#include "ns3/core-module.h"
+#include "ns3/net-builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+using namespace ns3;
+
+/** Name of this program. */
+std::string g_me;
+/** Log to std::cerr, keeping std::cout for the CSV. */
+#define LOG(x) std::cerr << x << std::endl
+/** Log with program name prefix. */
+#define LOGME(x) LOG(g_me << x)
+
+/**
+ * Peak resident set size of this process so far.
+ *
+ * @returns The peak RSS in KiB.
+ */
+uint64_t
+PeakRssKb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss; // KiB on Linux
+#endif
+}
+
+/**
+ * Times the route computation stages of one CentralController.
+ *
+ * This class is a friend of CentralController so that the private
+ * stages (Dijkstra, doUpdateRoutingTable, clearRoutingTable) can be
+ * timed on their own.
+ */
+class CentralControllerBench
+{
+  public:
+    /** One CSV row. */
+    struct Result
+    {
+        std::string stage;      /**< Stage name. */
+        uint64_t calls;         /**< Number of timed calls. */
+        double wall;            /**< Total wall time (s). */
+        uint64_t peakRss;       /**< Peak RSS after the stage (KiB). */
+        uint64_t routesTouched; /**< Routes (or link records) produced or removed. */
+    };
+
+    /**
+     * Constructor
+     * @param [in] nb The topology to run the controller on.
+     */
+    CentralControllerBench(NetBuilder nb)
+        : m_controller(nb)
+    {
+    }
+
+    /**
+     * Time Dijkstra from the first \p sources nodes.
+     * @param [in] sources The number of source nodes.
+     * @returns The Result.
+     */
+    Result Dijkstra(uint32_t sources);
+    /**
+     * Time one full routing table update.
+     * @returns The Result.
+     */
+    Result UpdateRoutingTable();
+    /**
+     * Time clearing the host routes installed by UpdateRoutingTable().
+     * @returns The Result.
+     */
+    Result ClearRoutingTable();
+    /**
+     * Time building the link state report.
+     * @returns The Result.
+     */
+    Result CollectNetInfo();
+
+  private:
+    /**
+     * Count the routes in every static routing table.
+     * @returns The total number of routes.
+     */
+    uint64_t CountRoutes();
+
+    CentralController m_controller; /**< The controller under test. */
+};
+
+/** Clock used for the stage timings. */
+using BenchClock = std::chrono::steady_clock;
+
+/**
+ * Seconds elapsed since \p start.
+ * @param [in] start The start time point.
+ * @returns The elapsed time (s).
+ */
+double
+Elapsed(BenchClock::time_point start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+CentralControllerBench::Result
+CentralControllerBench::Dijkstra(uint32_t sources)
+{
+    uint64_t touched = 0;
+    auto start = BenchClock::now();
+    for (uint32_t s = 0; s < sources; ++s)
+    {
+        std::vector<int> nextNodes = m_controller.Dijkstra(s);
+        touched += nextNodes.empty() ? 0 : nextNodes.size() - 1;
+    }
+    double wall = Elapsed(start);
+    return Result{"Dijkstra", sources, wall, PeakRssKb(), touched};
+}
+
+CentralControllerBench::Result
+CentralControllerBench::UpdateRoutingTable()
+{
+    uint64_t before = CountRoutes();
+    auto start = BenchClock::now();
+    m_controller.doUpdateRoutingTable();
+    double wall = Elapsed(start);
+    uint64_t after = CountRoutes();
+    return Result{"doUpdateRoutingTable", 1, wall, PeakRssKb(), after - before};
+}
+
+CentralControllerBench::Result
+CentralControllerBench::ClearRoutingTable()
+{
+    uint64_t before = CountRoutes();
+    auto start = BenchClock::now();
+    m_controller.clearRoutingTable();
+    double wall = Elapsed(start);
+    uint64_t after = CountRoutes();
+    return Result{"clearRoutingTable", 1, wall, PeakRssKb(), before - after};
+}
+
+CentralControllerBench::Result
+CentralControllerBench::CollectNetInfo()
+{
+    auto start = BenchClock::now();
+    std::string info = m_controller.CollectNetInfo();
+    double wall = Elapsed(start);
+    uint64_t records = std::count(info.begin(), info.end(), '\n');
+    return Result{"CollectNetInfo", 1, wall, PeakRssKb(), records};
+}
+
+uint64_t
+CentralControllerBench::CountRoutes()
+{
+    uint64_t routes = 0;
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    for (uint32_t i = 0; i < m_controller.m_nodes.GetN(); ++i)
+    {
+        Ptr<Ipv4StaticRouting> staticRouting = staticRoutingHelper.GetStaticRouting(
+            m_controller.m_nodes.Get(i)->GetObject<Ipv4>());
+        routes += staticRouting->GetNRoutes();
+    }
+    return routes;
+}
+
+/**
+ * Write the CSV header to std::cout.
+ */
+void
+CsvHeader()
+{
+    std::cout << "topology,nodes,links,stage,calls,wall_s,per_call_s,peak_rss_kb,routes_touched"
+              << std::endl;
+}
+
+/**
+ * Write one CSV row to std::cout.
+ * @param [in] topology The topology name.
+ * @param [in] nodes The number of nodes.
+ * @param [in] links The number of (undirected) links.
+ * @param [in] r The stage result.
+ */
+void
+CsvRow(const std::string& topology,
+       uint32_t nodes,
+       uint32_t links,
+       const CentralControllerBench::Result& r)
+{
+    std::cout << topology << "," << nodes << "," << links << "," << r.stage << "," << r.calls
+              << "," << r.wall << "," << (r.calls ? r.wall / r.calls : 0) << "," << r.peakRss
+              << "," << r.routesTouched << std::endl;
+}
+
+/**
+ * Count the undirected links of a topology.
+ * @param [in] nb The topology.
+ * @returns The number of links.
+ */
+uint32_t
+CountLinks(NetBuilder& nb)
+{
+    uint32_t links = 0;
+    std::vector<std::vector<int>> adj = nb.getAdj();
+    for (std::size_t i = 0; i < adj.size(); ++i)
+    {
+        for (std::size_t j = i + 1; j < adj.size(); ++j)
+        {
+            links += adj[i][j] != -1 ? 1 : 0;
+        }
+    }
+    return links;
+}
+
+/**
+ * Build a topology, run every stage on it and write the CSV rows.
+ * @param [in] topology The topology name: geant2, quad or cube.
+ * @param [in] size The requested node count (ignored for geant2).
+ * @param [in] sources The maximum number of Dijkstra sources.
+ * @param [in] maxRouteNodes Skip the routing table stages above this node count.
+ */
+void
+RunTopology(const std::string& topology, uint32_t size, uint32_t sources, uint32_t maxRouteNodes)
+{
+    NetBuilder nb;
+    if (topology == "geant2")
+    {
+        nb.GEANT2();
+    }
+    else if (topology == "quad")
+    {
+        // width x width grid
+        auto width = static_cast<int>(std::lround(std::sqrt(size)));
+        nb = NetBuilder(width * width);
+        nb.quadConnect(width);
+    }
+    else
+    {
+        // side x side x side mesh
+        auto side = static_cast<int>(std::lround(std::cbrt(size)));
+        nb = NetBuilder(side * side * side);
+        nb.cubeConnect(side, side);
+    }
+    uint32_t nodes = nb.getNodes().GetN();
+    uint32_t links = CountLinks(nb);
+    LOGME(" " << topology << ": " << nodes << " nodes, " << links << " links");
+
+    CentralControllerBench bench(nb);
+    CsvRow(topology, nodes, links, bench.Dijkstra(std::min(nodes, sources)));
+    if (nodes <= maxRouteNodes)
+    {
+        CsvRow(topology, nodes, links, bench.UpdateRoutingTable());
+        CsvRow(topology, nodes, links, bench.ClearRoutingTable());
+    }
+    else
+    {
+        LOGME("  skipping routing table stages (" << nodes << " > maxRouteNodes)");
+    }
+    CsvRow(topology, nodes, links, bench.CollectNetInfo());
+
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string sizes = "16,64,256,1024";
+    uint32_t sources = 64;
+    uint32_t maxRouteNodes = 1024;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the CentralController route computation.\n"
+              "\n"
+              "Times Dijkstra, doUpdateRoutingTable, clearRoutingTable and\n"
+              "CollectNetInfo on GEANT2 and on quadConnect grids and cubeConnect\n"
+              "meshes of each requested size, and writes CSV to standard output:\n"
+              "wall time, peak RSS so far and the number of routes touched\n"
+              "(for CollectNetInfo, the number of link records).\n"
+              "\n"
+              "The controller keeps dense n x n tables, so 10000 nodes needs\n"
+              "several GB of memory; raise --maxRouteNodes with care, every node\n"
+              "gets a host route to every other node.");
+    cmd.AddValue("sizes", "comma separated node counts for the grids and meshes", sizes);
+    cmd.AddValue("sources", "maximum number of Dijkstra source nodes per topology", sources);
+    cmd.AddValue("maxRouteNodes",
+                 "largest topology on which the routing table stages are run",
+                 maxRouteNodes);
+    cmd.Parse(argc, argv);
+
+    g_me = cmd.GetName() + ":";
+
+    CsvHeader();
+    RunTopology("geant2", 24, sources, maxRouteNodes);
+
+    std::istringstream iss(sizes);
+    std::string size;
+    while (std::getline(iss, size, ','))
+    {
+        RunTopology("quad", std::stoul(size), sources, maxRouteNodes);
+        RunTopology("cube", std::stoul(size), sources, maxRouteNodes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program measures how the Config path resolution scales with the
+// number of nodes, for a wildcard Config::Set and for one
+// Config::ConnectWithoutContext per node.
+// Sample usage:  ./ns3 run 'bench-config --nodes=1000,10000'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** The number of packets traced, to keep the sinks from being optimised out. */
+uint64_t g_traced = 0;
+
+/**
+ * Trace sink.
+ *
+ * @param [in] packet The packet.
+ */
+void
+PhyRxDrop(Ptr<const Packet> /* packet */)
+{
+    g_traced++;
+}
+
+/**
+ * Get the wall clock time elapsed since \p start.
+ *
+ * @param [in] start The start time.
+ * @returns The elapsed time (s).
+ */
+double
+Elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string nodeCounts = "1000,2000,5000,10000";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the Config path resolution.\n"
+              "\n"
+              "For each number of nodes, each with two devices, time a Config::Set on\n"
+              "all the devices and a Config::ConnectWithoutContext to each node in\n"
+              "turn, and write CSV to standard output.");
+    cmd.AddValue("nodes", "comma separated numbers of nodes", nodeCounts);
+    cmd.Parse(argc, argv);
+
+    std::cout << "nodes,set_all_s,connect_each_s,connect_per_node_us" << std::endl;
+    std::istringstream counts(nodeCounts);
+    std::string count;
+    while (std::getline(counts, count, ','))
+    {
+        uint32_t n = std::stoul(count);
+        NodeContainer nodes(n);
+        SimpleNetDeviceHelper helper;
+        helper.Install(nodes);
+        helper.Install(nodes);
+
+        auto start = std::chrono::steady_clock::now();
+        Config::Set("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/DataRate",
+                    DataRateValue(DataRate("1Gbps")));
+        double setAll = Elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            std::ostringstream path;
+            path << "/NodeList/" << i << "/DeviceList/1/$ns3::SimpleNetDevice/PhyRxDrop";
+            Config::ConnectWithoutContext(path.str(), MakeCallback(&PhyRxDrop));
+        }
+        double connectEach = Elapsed(start);
+
+        std::cout << n << "," << setAll << "," << connectEach << "," << 1e6 * connectEach / n
+                  << std::endl;
+        Simulator::Destroy();
+    }
+    return 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mpsc-queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/** Name of this program. */
+std::string g_me;
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+/** Log with program name prefix. */
+#define LOGME(x) LOG(g_me << x)
+
+/** Wall clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Seconds elapsed since a time point.
+ *
+ * @param [in] start The time point.
+ * @returns The elapsed time (s).
+ */
+double
+Elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * Log one result line.
+ *
+ * @param [in] label The label for the line.
+ * @param [in] items The number of items handed over.
+ * @param [in] seconds The time taken (s).
+ */
+void
+LogResult(const std::string& label, uint64_t items, double seconds)
+{
+    LOG(std::left << std::setw(28) << label << std::setw(14) << seconds << std::setw(14)
+                  << items / seconds);
+}
+
+/**
+ * Start producer threads once all of them are ready, and join them.
+ *
+ * @param [in] producers The number of producer threads.
+ * @param [in] produce The producer body, called with the thread number.
+ * @param [in] consume The consumer body, run on the calling thread
+ *             until it returns.
+ */
+template <typename P, typename C>
+void
+RunThreads(unsigned int producers, P produce, C consume)
+{
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([&go, &produce, i]() {
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+            produce(i);
+        });
+    }
+    go = true;
+    consume();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Hand items from the producers to one consumer through an MpscQueue.
+ * Producers retry when the queue is full.
+ *
+ * @param [in] producers The number of producer threads.
+ * @param [in] items The number of items per producer.
+ * @param [in] capacity The queue capacity.
+ * @returns The time taken (s).
+ */
+double
+BenchMpscQueue(unsigned int producers, uint64_t items, uint32_t capacity)
+{
+    MpscQueue<uint64_t> queue(capacity);
+    uint64_t total = producers * items;
+    auto start = Clock::now();
+    RunThreads(
+        producers,
+        [&queue, items](unsigned int) {
+            for (uint64_t i = 0; i < items; ++i)
+            {
+                while (!queue.Push(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        },
+        [&queue, total]() {
+            uint64_t item;
+            for (uint64_t received = 0; received < total;)
+            {
+                if (queue.Pop(item))
+                {
+                    ++received;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    return Elapsed(start);
+}
+
+/**
+ * Hand items from the producers to one consumer through a std::list
+ * under a mutex, the way DefaultSimulatorImpl used to: the consumer
+ * swaps the list out under the lock.
+ *
+ * @param [in] producers The number of producer threads.
+ * @param [in] items The number of items per producer.
+ * @returns The time taken (s).
+ */
+double
+BenchLockedList(unsigned int producers, uint64_t items)
+{
+    std::mutex mutex;
+    std::list<uint64_t> list;
+    uint64_t total = producers * items;
+    auto start = Clock::now();
+    RunThreads(
+        producers,
+        [&mutex, &list, items](unsigned int) {
+            for (uint64_t i = 0; i < items; ++i)
+            {
+                std::unique_lock lock{mutex};
+                list.push_back(i);
+            }
+        },
+        [&mutex, &list, total]() {
+            for (uint64_t received = 0; received < total;)
+            {
+                std::list<uint64_t> batch;
+                {
+                    std::unique_lock lock{mutex};
+                    batch.swap(list);
+                }
+                if (batch.empty())
+                {
+                    std::this_thread::yield();
+                }
+                received += batch.size();
+            }
+        });
+    return Elapsed(start);
+}
+
+/**
+ * Inject events into a running simulation with
+ * Simulator::ScheduleWithContext() from several threads.
+ */
+class SimulatorBench
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * @param [in] producers The number of producer threads.
+     * @param [in] items The number of events per producer.
+     */
+    SimulatorBench(unsigned int producers, uint64_t items)
+        : m_producers(producers),
+          m_items(items),
+          m_received(0),
+          m_go(false)
+    {
+    }
+
+    /**
+     * Run the simulation until all the events have been received.
+     *
+     * @param [in] simulatorType The SimulatorImpl type.
+     * @returns The time taken (s).
+     */
+    double Run(const std::string& simulatorType)
+    {
+        GlobalValue::Bind("SimulatorImplementationType", StringValue(simulatorType));
+        m_received = 0;
+        m_go = false;
+        Simulator::Schedule(Time(0), &SimulatorBench::Tick, this);
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < m_producers; ++i)
+        {
+            threads.emplace_back(&SimulatorBench::Produce, this, i);
+        }
+        auto start = Clock::now();
+        Simulator::Run();
+        double seconds = Elapsed(start);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        Simulator::Destroy();
+        return seconds;
+    }
+
+  private:
+    /**
+     * Producer thread body.
+     * @param [in] context The event context.
+     */
+    void Produce(uint32_t context)
+    {
+        while (!m_go)
+        {
+            std::this_thread::yield();
+        }
+        for (uint64_t i = 0; i < m_items; ++i)
+        {
+            Simulator::ScheduleWithContext(context, Time(0), &SimulatorBench::Receive, this);
+        }
+    }
+
+    /** Injected event. */
+    void Receive()
+    {
+        ++m_received;
+    }
+
+    /** Keep the simulation going until all the events have been received. */
+    void Tick()
+    {
+        m_go = true;
+        if (m_received == m_producers * m_items)
+        {
+            Simulator::Stop();
+            return;
+        }
+        Simulator::Schedule(MicroSeconds(1), &SimulatorBench::Tick, this);
+    }
+
+    unsigned int m_producers; /**< Number of producer threads. */
+    uint64_t m_items;         /**< Events per producer. */
+    uint64_t m_received;      /**< Events received so far. */
+    std::atomic<bool> m_go;   /**< Start producing. */
+};
+
+int
+main(int argc, char* argv[])
+{
+    unsigned int producers = 4;
+    uint64_t items = 1000000;
+    uint64_t events = 100000;
+    uint32_t capacity = 4096;
+    bool realtime = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the injection of events from other threads.\n"
+              "\n"
+              "First hands items from several producer threads to one consumer,\n"
+              "through an MpscQueue and through a std::list under a mutex.\n"
+              "Then schedules events with Simulator::ScheduleWithContext()\n"
+              "from the producer threads into a running simulation.");
+    cmd.AddValue("producers", "number of producer threads", producers);
+    cmd.AddValue("items", "items per producer for the queue benchmark", items);
+    cmd.AddValue("events", "events per producer for the simulator benchmark", events);
+    cmd.AddValue("capacity", "MpscQueue capacity for the queue benchmark", capacity);
+    cmd.AddValue("realtime", "also run the RealtimeSimulatorImpl", realtime);
+    cmd.Parse(argc, argv);
+
+    g_me = cmd.GetName() + ": ";
+
+    LOG(std::setprecision(6));
+    LOGME(" Benchmark the injection of events from other threads");
+    LOG("  Producer threads:              " << producers);
+    LOG("  Hardware threads:              " << std::thread::hardware_concurrency());
+    LOG("");
+    LOG(std::left << std::setw(28) << "Hand-over" << std::setw(14) << "Time (s)" << std::setw(14)
+                  << "Rate (/s)");
+
+    uint64_t total = producers * items;
+    LogResult("MpscQueue", total, BenchMpscQueue(producers, items, capacity));
+    LogResult("mutex + std::list", total, BenchLockedList(producers, items));
+
+    SimulatorBench bench(producers, events);
+    total = producers * events;
+    LogResult("DefaultSimulatorImpl", total, bench.Run("ns3::DefaultSimulatorImpl"));
+    if (realtime)
+    {
+        LogResult("RealtimeSimulatorImpl", total, bench.Run("ns3::RealtimeSimulatorImpl"));
+    }
+
+    return 0;
+}
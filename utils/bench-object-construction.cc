@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program measures the throughput of object construction by name,
+// as in topology construction: TypeId lookup, construction with
+// attributes, then attributes set and trace sources connected by name,
+// and of the TypeId lookups by name alone.
+// Sample usage:  ./ns3 run 'bench-object-construction --n=100000'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * Trace sink.
+ *
+ * @param [in] packet The packet.
+ */
+void
+Sink(Ptr<const Packet> /* packet */)
+{
+}
+
+/**
+ * Construct objects the way the helpers do.
+ *
+ * @param [in] n The number of objects of each type.
+ * @returns The number of objects constructed.
+ */
+uint64_t
+Construct(uint32_t n)
+{
+    ObjectFactory deviceFactory("ns3::SimpleNetDevice");
+    deviceFactory.Set("PointToPointMode", BooleanValue(true));
+    ObjectFactory queueFactory("ns3::DropTailQueue<Packet>");
+    queueFactory.Set("MaxSize", QueueSizeValue(QueueSize("100p")));
+
+    uint64_t objects = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        TypeId tid = TypeId::LookupByName("ns3::SimpleNetDevice");
+        Ptr<Object> device = deviceFactory.Create();
+        device->SetAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+        device->SetAttribute("PointToPointMode", BooleanValue(false));
+        device->SetAttribute("TxQueue", PointerValue(queueFactory.Create()));
+        device->TraceConnectWithoutContext("PhyRxDrop", MakeCallback(&Sink));
+        DataRateValue rate;
+        device->GetAttribute("DataRate", rate);
+        NS_ABORT_UNLESS(device->GetInstanceTypeId() == tid);
+        objects += 2;
+    }
+    return objects;
+}
+
+/**
+ * Look up a TypeId, an Attribute and a TraceSource by name.
+ *
+ * @param [in] n The number of times.
+ * @returns The number of lookups.
+ */
+uint64_t
+Lookup(uint32_t n)
+{
+    uint64_t lookups = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        TypeId tid = TypeId::LookupByName("ns3::SimpleNetDevice");
+        TypeId::AttributeInformation attribute;
+        TypeId::TraceSourceInformation source;
+        NS_ABORT_UNLESS(tid.LookupAttributeByName("TxQueue", &attribute));
+        NS_ABORT_UNLESS(tid.LookupTraceSourceByName("PhyRxDrop", &source));
+        lookups += 3;
+    }
+    return lookups;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t runs = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark object construction by name.\n"
+              "\n"
+              "Constructs SimpleNetDevices and their queues with ObjectFactory, sets\n"
+              "and gets attributes and connects a trace source by name, then looks\n"
+              "up the TypeId, an attribute and a trace source by name alone, and\n"
+              "writes CSV to standard output.");
+    cmd.AddValue("n", "number of devices in a run", n);
+    cmd.AddValue("runs", "number of runs", runs);
+    cmd.Parse(argc, argv);
+
+    std::cout << "run,objects,wall_s,objects_per_s,lookups,lookup_wall_s,lookups_per_s"
+              << std::endl;
+    for (uint32_t run = 0; run < runs; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t objects = Construct(n);
+        double wall =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        uint64_t lookups = Lookup(n);
+        double lookupWall =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << run << "," << objects << "," << wall << "," << objects / wall << ","
+                  << lookups << "," << lookupWall << "," << lookups / lookupWall << std::endl;
+    }
+    return 0;
+}
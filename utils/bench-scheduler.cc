@@ -9,9 +9,11 @@
 #include "ns3/core-module.h"
 
 #include <cmath> // sqrt
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <string.h>
 #include <vector>
 
@@ -36,6 +38,48 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Number of calls to the global operator new. */
+uint64_t g_allocations = 0;
+
+/**
+ * Replacement of the global operator new, counting the allocations.
+ *
+ * @param [in] size The number of bytes to allocate.
+ * @returns The allocated storage.
+ */
+void*
+operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * Replacement of the global operator delete, matching operator new.
+ *
+ * @param [in] p The storage to release.
+ */
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Replacement of the global sized operator delete, matching operator new.
+ *
+ * @param [in] p The storage to release.
+ */
+void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    std::free(p);
+}
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -55,7 +99,8 @@ class Bench
     Bench(const uint64_t population, const uint64_t total)
         : m_population(population),
           m_total(total),
-          m_count(0)
+          m_count(0),
+          m_quantum(0)
     {
     }
 
@@ -70,6 +115,28 @@ class Bench
         m_rand = stream;
     }
 
+    /**
+     * Set the scheduler to run with.  Simulator::Destroy() reverts to
+     * the default scheduler, so it is set again before every run.
+     *
+     * @param [in] factory Factory pre-configured to create the desired Scheduler.
+     */
+    void SetScheduler(const ObjectFactory& factory)
+    {
+        m_factory = factory;
+    }
+
+    /**
+     * Round the event delays to a multiple of a quantum, so that many
+     * events share the same time stamp.
+     *
+     * @param [in] quantum The quantum, in ns; 0 to keep the delays as drawn.
+     */
+    void SetQuantum(const uint64_t quantum)
+    {
+        m_quantum = quantum;
+    }
+
     /**
      * Set the number of events to populate the scheduler with.
      * Each event executed schedules a new event, maintaining the population.
@@ -96,6 +163,7 @@ class Bench
         double simu;     /**< Time (s) for simulation. */
         uint64_t pop;    /**< Event population. */
         uint64_t events; /**< Number of events executed. */
+        uint64_t allocs; /**< Number of heap allocations during simulation. */
     };
 
     /**
@@ -112,10 +180,19 @@ class Bench
      */
     void Cb();
 
+    /**
+     * Draw the next event delay.
+     *
+     * @returns The delay, rounded to the quantum if one is set.
+     */
+    Time NextDelay();
+
+    ObjectFactory m_factory;          /**< Factory for the scheduler. */
     Ptr<RandomVariableStream> m_rand; /**< Stream for event delays. */
     uint64_t m_population;            /**< Event population size. */
     uint64_t m_total;                 /**< Total number of events to execute. */
     uint64_t m_count;                 /**< Count of events executed so far. */
+    uint64_t m_quantum;               /**< Delay quantum (ns), 0 for none. */
 
 }; // class Bench
 
@@ -128,25 +205,28 @@ Bench::Run()
 
     DEB("initializing");
     m_count = 0;
+    Simulator::SetScheduler(m_factory);
 
     timer.Start();
     for (uint64_t i = 0; i < m_population; ++i)
     {
-        Time at = NanoSeconds(m_rand->GetValue());
+        Time at = NextDelay();
         Simulator::Schedule(at, &Bench::Cb, this);
     }
     init = timer.End() / 1000.0;
     DEB("initialization took " << init << "s");
 
     DEB("running");
+    uint64_t allocs = g_allocations;
     timer.Start();
     Simulator::Run();
     simu = timer.End() / 1000.0;
-    DEB("run took " << simu << "s");
+    allocs = g_allocations - allocs;
+    DEB("run took " << simu << "s, " << allocs << " allocations");
 
     Simulator::Destroy();
 
-    return Result{init, simu, m_population, m_count};
+    return Result{init, simu, m_population, m_count, allocs};
 }
 
 void
@@ -159,11 +239,22 @@ Bench::Cb()
     }
     DEB("event at " << Simulator::Now().GetSeconds() << "s");
 
-    Time after = NanoSeconds(m_rand->GetValue());
+    Time after = NextDelay();
     Simulator::Schedule(after, &Bench::Cb, this);
     ++m_count;
 }
 
+Time
+Bench::NextDelay()
+{
+    auto delay = static_cast<uint64_t>(m_rand->GetValue());
+    if (m_quantum > 0)
+    {
+        delay = (delay + m_quantum / 2) / m_quantum * m_quantum;
+    }
+    return NanoSeconds(delay);
+}
+
 /** Benchmark which performs an ensemble of runs. */
 class BenchSuite
 {
@@ -182,13 +273,15 @@ class BenchSuite
      * @param [in] runs The number of replications.
      * @param [in] eventStream The random stream of event delays.
      * @param [in] calRev For the CalendarScheduler, whether the Reverse attribute was set.
+     * @param [in] quantum The event delay quantum (ns), 0 for none.
      */
     BenchSuite(ObjectFactory& factory,
                uint64_t pop,
                uint64_t total,
                uint64_t runs,
                Ptr<RandomVariableStream> eventStream,
-               bool calRev);
+               bool calRev,
+               uint64_t quantum);
 
     /** Write the results to \c LOG() */
     void Log() const;
@@ -197,6 +290,9 @@ class BenchSuite
     /** Print the table header. */
     void Header() const;
 
+    /** Print the number of heap allocations per event executed. */
+    void LogAllocations() const;
+
     /** Statistics from a single phase, init or run. */
     struct PhaseResult
     {
@@ -230,6 +326,8 @@ class BenchSuite
 
     std::string m_scheduler;       /**< Descriptive string for the scheduler. */
     std::vector<Result> m_results; /**< Store for the run results. */
+    uint64_t m_allocs;             /**< Heap allocations during the runs. */
+    uint64_t m_events;             /**< Events executed during the runs. */
 
 }; // BenchSuite
 
@@ -258,10 +356,11 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
                        uint64_t total,
                        uint64_t runs,
                        Ptr<RandomVariableStream> eventStream,
-                       bool calRev)
+                       bool calRev,
+                       uint64_t quantum)
+    : m_allocs(0),
+      m_events(0)
 {
-    Simulator::SetScheduler(factory);
-
     m_scheduler = factory.GetTypeId().GetName();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
@@ -273,9 +372,11 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     }
 
     Bench bench(pop, total);
+    bench.SetScheduler(factory);
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
     bench.SetTotal(total);
+    bench.SetQuantum(quantum);
 
     m_results.reserve(runs);
     Header();
@@ -289,6 +390,8 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     for (uint64_t i = 0; i < runs; i++)
     {
         auto run = bench.Run();
+        m_allocs += run.allocs;
+        m_events += run.events;
         m_results.push_back(Result::Bench(run));
         m_results.back().Log(i);
     }
@@ -317,11 +420,22 @@ BenchSuite::Header() const
                           << std::right << std::setw(g_fwidth) << " " << std::setfill(' '));
 }
 
+void
+BenchSuite::LogAllocations() const
+{
+    if (m_events > 0)
+    {
+        LOG(std::left << std::setw(g_fwidth) << "alloc/ev"
+                      << static_cast<double>(m_allocs) / m_events);
+    }
+}
+
 void
 BenchSuite::Log() const
 {
     if (m_results.size() < 2)
     {
+        LogAllocations();
         LOG("");
         return;
     }
@@ -371,6 +485,7 @@ BenchSuite::Log() const
 
     average.Log("average");
     stdev.Log("stdev");
+    LogAllocations();
 
     LOG("");
 
@@ -449,12 +564,14 @@ main(int argc, char* argv[])
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
+    bool schedLadder = false;
 
     uint64_t pop = 100000;
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
     bool calRev = false;
+    uint64_t quantum = 0;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
@@ -465,6 +582,8 @@ main(int argc, char* argv[])
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
+              "With --quantum the delays are rounded to a multiple of the\n"
+              "quantum, to model many events sharing the same time stamp.\n"
               "\n"
               "If no scheduler is specified the MapScheduler will be run.");
     cmd.AddValue("all", "use all schedulers", allSched);
@@ -474,11 +593,13 @@ main(int argc, char* argv[])
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("debug", "enable debugging output", g_debug);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("quantum", "round event delays to a multiple of this (ns)", quantum);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
 
@@ -490,14 +611,19 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+    if (quantum > 0)
+    {
+        LOG("  Event delay quantum (ns):     " << quantum);
+    }
+    LOG("  Event allocation pool:        " << (EventImpl::IsPoolEnabled() ? "on" : "off"));
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedList = schedMap = schedPQ = schedLadder = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ || schedLadder))
     {
         schedMap = true;
     }
@@ -509,17 +635,17 @@ main(int argc, char* argv[])
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, eventStream, calRev, quantum).Log();
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            BenchSuite(factory, pop, total, runs, eventStream, !calRev, quantum).Log();
         }
     }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, eventStream, calRev, quantum).Log();
     }
     if (schedList)
     {
@@ -530,17 +656,22 @@ main(int argc, char* argv[])
             LOG("Running List scheduler with 1/10 total events");
             listTotal /= 10;
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev, quantum).Log();
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, eventStream, calRev, quantum).Log();
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        BenchSuite(factory, pop, total, runs, eventStream, calRev, quantum).Log();
+    }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev, quantum).Log();
     }
 
     return 0;
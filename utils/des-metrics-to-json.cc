@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/des-metrics.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * @file
+ * @ingroup simulator
+ * Convert a binary DesMetrics trace to the JSON format.
+ */
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Convert a binary DES Metrics trace, written with --DesMetricsFormat=binary,\n"
+              "to the JSON format of the DES Metrics analysis tools.");
+    cmd.AddNonOption("input", "binary trace file", input);
+    cmd.AddNonOption("output", "JSON trace file, or the standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    std::ifstream is(input, std::ios::binary);
+    if (!is)
+    {
+        std::cerr << cmd.GetName() << ": cannot open " << input << std::endl;
+        return 1;
+    }
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        if (!file)
+        {
+            std::cerr << cmd.GetName() << ": cannot open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+
+    if (!DesMetrics::ConvertToJson(is, os))
+    {
+        std::cerr << cmd.GetName() << ": " << input << " is not a binary DES Metrics trace, "
+                  << "or is truncated" << std::endl;
+        return 1;
+    }
+    return 0;
+}
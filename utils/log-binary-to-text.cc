@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/log-binary-sink.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * @file
+ * @ingroup logging
+ * Decode a binary log written by the LogBinarySink to text.
+ */
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    bool allPrefixes = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Decode a binary log, written with NS_LOG_BINARY=<file>,\n"
+              "to the text the NS_LOG statements would have printed.");
+    cmd.AddValue("allPrefixes",
+                 "Print the time, node, function and level of all the messages",
+                 allPrefixes);
+    cmd.AddNonOption("input", "binary log file", input);
+    cmd.AddNonOption("output", "text log file, or the standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    std::ifstream is(input, std::ios::binary);
+    if (!is)
+    {
+        std::cerr << cmd.GetName() << ": cannot open " << input << std::endl;
+        return 1;
+    }
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        if (!file)
+        {
+            std::cerr << cmd.GetName() << ": cannot open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+
+    if (LogBinarySink::Decode(is, os, allPrefixes) < 0)
+    {
+        std::cerr << cmd.GetName() << ": " << input << " is not a binary log, "
+                  << "or is truncated" << std::endl;
+        return 1;
+    }
+    return 0;
+}